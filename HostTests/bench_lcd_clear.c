@@ -0,0 +1,64 @@
+/**
+ * bench_lcd_clear.c
+ * Full screen clear on the emulated SSI0 bus of lcd_host.c, before and after streaming
+ *  - Before: the old LCD_Clear body, every pixel as two LCD_WriteData calls with CS toggled and SSIBusy waited on
+ *  - After: LCD_Clear as it is now, 16-bit frames with CS held low and the FIFO kept full
+ *  - Times are the host model, the on target number is the "clear took" line main.c prints
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ILI9341_Lib.h"
+#include "driverlib/sysctl.h"
+#include "lcd_host.h"
+
+/*
+ * LCD_Clear before LCD_StreamFill existed
+ */
+static void LegacyClear(uint16_t color)
+{
+    LCD_SetAddress(0, 0, MAX_SCREEN_X, MAX_SCREEN_Y);
+    int count = MAX_SCREEN_X * MAX_SCREEN_Y;
+    for (int i = 0; i < count; i++)
+    {
+        LCD_PushColor(color);
+    }
+    LCD_EndCommand();
+}
+
+/*
+ * Runs one clear from an idle bus with the window cache cold, so both sides send the window
+ */
+static hostBus_t Measure(void (*clear)(uint16_t color))
+{
+    LCD_SetAddress(0, 0, 0, 0);
+    LCD_EndCommand();
+    HostResetBus();
+    clear(LCD_BLACK);               // ends on the NOP, which waits for the last bit
+    return HostBus;
+}
+
+static void Report(const char *name, hostBus_t *b)
+{
+    printf("  %-7s %6u frames %6u bytes %6u CS selects %7u GPIO writes %6u SSIBusy calls %8.2f ms\n",
+           name, b->frames, b->wireBytes, b->csSelects, b->gpioWrites, b->busyPolls, b->timePs / 1e9);
+}
+
+int main(void)
+{
+    LCD_ClockChanged(SysCtlClockGet());
+    HostCapture = false;
+
+    hostBus_t before = Measure(LegacyClear);
+    hostBus_t after = Measure(LCD_Clear);
+
+    printf("bench_lcd_clear: %ux%u pixels, SSI0 at 12 MHz, CPU at 80 MHz\n", MAX_SCREEN_X, MAX_SCREEN_Y);
+    Report("before", &before);
+    Report("after", &after);
+    printf("  wire floor %.2f ms, speedup %.2fx\n", after.wireBytes * 8 / 12e3, (double)before.timePs / after.timePs);
+
+    CHECK(after.wireBytes == before.wireBytes);     // same bytes, only the framing changed
+    CHECK(after.timePs < before.timePs);
+    return 0;
+}
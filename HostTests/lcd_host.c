@@ -0,0 +1,194 @@
+/**
+ * lcd_host.c
+ * Host stand-in for SSI0, the LCD GPIOs and the kernel calls ILI9341_Lib.c makes
+ *
+ * Timing model, everything else is free:
+ *  - SSI0 shifts frames back to back at the rate SSIConfigSetExpClk was given, behind an 8 entry TX FIFO
+ *  - A data register write with the FIFO full waits for the oldest entry to start shifting
+ *  - SSIBusy waits for the line to go idle
+ *  - Driverlib calls and data register writes cost the cycles below at SysCtlClockGet
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "G8RTOS.h"
+#include "driverlib/gpio.h"
+#include "inc/hw_memmap.h"
+#include "inc/tm4c123gh6pm.h"
+#include "lcd_host.h"
+
+#define HOST_CPU_HZ             80000000
+#define HOST_SSI_FIFO_DEPTH     8
+#define HOST_CALL_CYCLES        8           // BL, the register access, BX LR
+#define HOST_DR_WRITE_CYCLES    6           // the TNF check, the store and the loop around them
+
+#define HOST_CPU_PS(cycles)     ((uint64_t)(cycles) * 1000000000000ULL / HOST_CPU_HZ)
+
+/*********************************************** SSI Capture **************************************************************************/
+
+frame_t Frames[MAX_FRAMES];
+uint32_t NumberOfFrames;
+uint8_t PinCS = 1, PinDC = 1;
+bool HostCapture = true;
+hostBus_t HostBus;
+
+uint32_t HostRegs[1];
+volatile uint32_t HostSSI0_SR = SSI_SR_TNF;     // TX FIFO never full, HostSSIPush models the wait instead
+volatile uint32_t HostSSI0_CR0 = 7;             // 8-bit frames, as LCD_ClockChanged leaves it
+volatile uint32_t HostGPIO_PUR;
+
+static uint64_t BitPs = 1000000000000ULL / 12000000;
+static uint64_t LineIdlePs;                         // when the shift register empties
+static uint64_t FifoStartPs[HOST_SSI_FIFO_DEPTH];   // when each of the last FIFO entries starts shifting
+static uint32_t DiscardedFrame;
+
+volatile uint32_t *HostSSIPush(void)
+{
+    uint8_t bits = (HostSSI0_CR0 & SSI_CR0_DSS_M) + 1;
+    uint32_t slot = HostBus.frames % HOST_SSI_FIFO_DEPTH;
+
+    if(FifoStartPs[slot] > HostBus.timePs)          // FIFO full, spin on TNF
+    {
+        HostBus.timePs = FifoStartPs[slot];
+    }
+    HostBus.timePs += HOST_CPU_PS(HOST_DR_WRITE_CYCLES);
+
+    uint64_t start = (LineIdlePs > HostBus.timePs) ? LineIdlePs : HostBus.timePs;
+    FifoStartPs[slot] = start;
+    LineIdlePs = start + bits * BitPs;
+
+    HostBus.frames++;
+    HostBus.wireBytes += bits / 8;
+
+    if(!HostCapture)
+    {
+        return (volatile uint32_t *)&DiscardedFrame;
+    }
+    CHECK(NumberOfFrames < MAX_FRAMES);
+    frame_t *f = &Frames[NumberOfFrames++];
+    f->bits = bits;
+    f->cs = PinCS;
+    f->dc = PinDC;
+    return (volatile uint32_t *)&f->value;
+}
+
+/*
+ * Expands the captured frames to wire bytes, MSB first as the SSI shifts them out
+ *  - Every frame must have gone out with CS low
+ */
+uint32_t WireBytes(wireByte_t *out)
+{
+    uint32_t n = 0;
+    for(uint32_t i = 0; i < NumberOfFrames; i++)
+    {
+        CHECK(Frames[i].cs == 0);
+        CHECK(Frames[i].bits == 8 || Frames[i].bits == 16);
+        if(Frames[i].bits == 16)
+        {
+            out[n++] = (wireByte_t){ (Frames[i].value >> 8) & 0xFF, Frames[i].dc };
+        }
+        out[n++] = (wireByte_t){ Frames[i].value & 0xFF, Frames[i].dc };
+    }
+    return n;
+}
+
+void ResetCapture(void)
+{
+    NumberOfFrames = 0;
+}
+
+/*
+ * Starts counting from an idle bus
+ */
+void HostResetBus(void)
+{
+    memset(&HostBus, 0, sizeof(HostBus));
+    memset(FifoStartPs, 0, sizeof(FifoStartPs));
+    LineIdlePs = 0;
+}
+
+/*********************************************** SSI Capture **************************************************************************/
+
+
+/*********************************************** Host Stubs ***************************************************************************/
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    HostBus.gpioWrites++;
+    HostBus.timePs += HOST_CPU_PS(HOST_CALL_CYCLES);
+    if(ui32Port == GPIO_PORTE_BASE && (ui8Pins & GPIO_PIN_0) && PinCS && !(ui8Val & GPIO_PIN_0))
+    {
+        HostBus.csSelects++;
+    }
+    if(ui32Port == GPIO_PORTE_BASE && (ui8Pins & GPIO_PIN_0))
+    {
+        PinCS = (ui8Val & GPIO_PIN_0) ? 1 : 0;
+    }
+    if(ui32Port == GPIO_PORTD_BASE && (ui8Pins & GPIO_PIN_0))
+    {
+        PinDC = (ui8Val & GPIO_PIN_0) ? 1 : 0;
+    }
+}
+
+bool SSIBusy(uint32_t ui32Base)
+{
+    HostBus.busyPolls++;
+    HostBus.timePs += HOST_CPU_PS(HOST_CALL_CYCLES);
+    if(LineIdlePs > HostBus.timePs)                 // the caller's spin, collapsed into one poll
+    {
+        HostBus.timePs = LineIdlePs;
+    }
+    return false;
+}
+
+void SSIEnable(uint32_t ui32Base) {}
+void SSIDisable(uint32_t ui32Base) {}
+void SSIConfigSetExpClk(uint32_t b, uint32_t c, uint32_t p, uint32_t m, uint32_t r, uint32_t w)
+{
+    HostSSI0_CR0 = w - 1;
+    BitPs = 1000000000000ULL / r;
+}
+
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags) {}
+void SSIDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags) {}
+
+void GPIOIntClear(uint32_t p, uint32_t f) {}
+void GPIOIntEnable(uint32_t p, uint32_t f) {}
+void GPIOIntTypeSet(uint32_t p, uint8_t pins, uint32_t t) {}
+void GPIOPinConfigure(uint32_t c) {}
+void GPIOPinTypeGPIOInput(uint32_t p, uint8_t pins) {}
+void GPIOPinTypeGPIOOutput(uint32_t p, uint8_t pins) {}
+void GPIOPinTypeSSI(uint32_t p, uint8_t pins) {}
+void IntEnable(uint32_t i) {}
+void IntPendClear(uint32_t i) {}
+uint32_t SysCtlClockGet(void) { return HOST_CPU_HZ; }
+void SysCtlPeripheralEnable(uint32_t p) {}
+bool SysCtlPeripheralReady(uint32_t p) { return true; }
+
+void uDMAChannelAssign(uint32_t m) {}
+void uDMAChannelAttributeDisable(uint32_t c, uint32_t a) {}
+void uDMAChannelControlSet(uint32_t c, uint32_t ctl) {}
+void uDMAChannelEnable(uint32_t c) {}
+bool uDMAChannelIsEnabled(uint32_t c) { return false; }
+uint32_t uDMAChannelModeGet(uint32_t c) { return 0; }
+void uDMAChannelTransferSet(uint32_t c, uint32_t m, void *s, void *d, uint32_t n) {}
+void uDMAControlBaseSet(void *t) {}
+void uDMAEnable(void) {}
+
+bool ClockManager_Register(void (*callback)(uint32_t clockHz)) { return true; }
+
+int32_t StartCriticalSection() { return 0; }
+void EndCriticalSection(int32_t IBit_State) {}
+uint64_t G8RTOS_GetTimeUs(void) { static uint64_t t; return t += 1000; }
+bool G8RTOS_CanBlock(void) { return false; }
+sched_ErrCode_t G8RTOS_AddDeferredEvent(void (*t)(void), void (*b)(void), uint8_t p, int32_t i) { return NO_ERROR; }
+void G8RTOS_InitSemaphore(semaphore_t *s, int32_t v) {}
+void G8RTOS_WaitSemaphore(semaphore_t *s) {}
+void G8RTOS_SignalSemaphore(semaphore_t *s) {}
+void G8RTOS_InitCondition(condition_t *c) {}
+void G8RTOS_WaitCondition(condition_t *c, semaphore_t *m) {}
+void G8RTOS_BroadcastCondition(condition_t *c) {}
+
+/*********************************************** Host Stubs ***************************************************************************/
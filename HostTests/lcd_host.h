@@ -0,0 +1,53 @@
+/**
+ * lcd_host.h
+ * Host stand-in for SSI0, the LCD GPIOs and the kernel calls ILI9341_Lib.c makes
+ *  - Data register writes can be captured with the frame size, CS and DC they went out with
+ *  - A small SSI0 timing model (TX FIFO, bit rate, CPU cost per call) gives an emulated bus time
+ */
+
+#ifndef LCD_HOST_H_
+#define LCD_HOST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define CHECK(cond) do { if(!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } } while(0)
+
+#define MAX_FRAMES 4096
+
+typedef struct {
+    uint32_t value;
+    uint8_t bits;
+    uint8_t cs;
+    uint8_t dc;
+} frame_t;
+
+/* One byte as it crosses the wire, with the DC level the controller latches it with */
+typedef struct {
+    uint8_t byte;
+    uint8_t dc;
+} wireByte_t;
+
+/* What the driver did to the bus since HostResetBus */
+typedef struct {
+    uint32_t frames;        // SSI0 data register writes
+    uint32_t wireBytes;
+    uint32_t busyPolls;     // SSIBusy calls
+    uint32_t gpioWrites;    // GPIOPinWrite calls, CS and DC
+    uint32_t csSelects;     // CS high to low edges
+    uint64_t timePs;        // emulated time, picoseconds
+} hostBus_t;
+
+extern frame_t Frames[MAX_FRAMES];
+extern uint32_t NumberOfFrames;
+extern uint8_t PinCS, PinDC;
+extern bool HostCapture;    // false: only count, for transfers longer than MAX_FRAMES
+extern hostBus_t HostBus;
+
+uint32_t WireBytes(wireByte_t *out);
+void ResetCapture(void);
+void HostResetBus(void);
+
+#endif /* LCD_HOST_H_ */
@@ -0,0 +1,7 @@
+/* Host stub */
+#ifndef HW_INTS_H_
+#define HW_INTS_H_
+#define INT_GPIOB               17
+#define INT_SSI0                23
+#define NUM_INTERRUPTS          155
+#endif
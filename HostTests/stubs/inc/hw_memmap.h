@@ -0,0 +1,9 @@
+/* Host stub: base addresses are only used as keys by the stubbed driverlib calls */
+#ifndef HW_MEMMAP_H_
+#define HW_MEMMAP_H_
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTD_BASE         0x40007000
+#define GPIO_PORTE_BASE         0x40024000
+#define SSI0_BASE               0x40008000
+#endif
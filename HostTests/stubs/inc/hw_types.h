@@ -0,0 +1,8 @@
+/* Host stub: HWREG is never touched by the code under test */
+#ifndef HW_TYPES_H_
+#define HW_TYPES_H_
+#include <stdint.h>
+#include <stdbool.h>
+extern uint32_t HostRegs[];
+#define HWREG(x)                (HostRegs[0])
+#endif
@@ -0,0 +1,16 @@
+/*
+ * Host stub: SSI0 registers are plain variables
+ *  - A write to SSI0_DR_R lands in the capture of lcd_host.c with the frame size, CS and DC at that moment
+ */
+#ifndef TM4C123GH6PM_H_
+#define TM4C123GH6PM_H_
+#include <stdint.h>
+extern volatile uint32_t *HostSSIPush(void);
+extern volatile uint32_t HostSSI0_SR, HostSSI0_CR0, HostGPIO_PUR;
+#define SSI0_DR_R               (*HostSSIPush())
+#define SSI0_SR_R               HostSSI0_SR
+#define SSI0_CR0_R              HostSSI0_CR0
+#define SSI_SR_TNF              0x00000002
+#define SSI_CR0_DSS_M           0x0000000F
+#define GPIO_PORTB_PUR_R        HostGPIO_PUR
+#endif
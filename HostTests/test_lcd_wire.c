@@ -0,0 +1,264 @@
+/**
+ * test_lcd_wire.c
+ * Host test for the SSI byte stream of ILI9341_Lib.c
+ *  - SSI0 data register writes are captured by lcd_host.c with the frame size, CS and DC they went out with
+ *  - 16-bit pixel frames must put the same bytes on the wire, in the same order, as the old 8-bit writes
+ *  - Text drawn as one window must land on the same pixels as the old per-pixel path
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ILI9341_Lib.h"
+#include "driverlib/sysctl.h"
+#include "inc/tm4c123gh6pm.h"
+#include "lcd_host.h"
+
+/*
+ * Bytes the pre-16-bit driver sent for a rectangle: the window, then two 8-bit data writes per pixel, then NOP
+ */
+static uint32_t LegacyRectangle(wireByte_t *out, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    uint32_t n = 0;
+    uint16_t x1 = MAX_SCREEN_X - (x + w - 1), x2 = MAX_SCREEN_X - x;
+    uint16_t y1 = y, y2 = y + h - 1;
+
+    out[n++] = (wireByte_t){ 0x2B, 0 };
+    out[n++] = (wireByte_t){ x1 >> 8, 1 };
+    out[n++] = (wireByte_t){ x1 & 0xFF, 1 };
+    out[n++] = (wireByte_t){ x2 >> 8, 1 };
+    out[n++] = (wireByte_t){ x2 & 0xFF, 1 };
+    out[n++] = (wireByte_t){ 0x2A, 0 };
+    out[n++] = (wireByte_t){ y1 >> 8, 1 };
+    out[n++] = (wireByte_t){ y1 & 0xFF, 1 };
+    out[n++] = (wireByte_t){ y2 >> 8, 1 };
+    out[n++] = (wireByte_t){ y2 & 0xFF, 1 };
+    out[n++] = (wireByte_t){ 0x2C, 0 };
+    for(uint32_t i = 0; i < (uint32_t)w * h; i++)
+    {
+        out[n++] = (wireByte_t){ color >> 8, 1 };
+        out[n++] = (wireByte_t){ color & 0xFF, 1 };
+    }
+    out[n++] = (wireByte_t){ 0x00, 0 };
+    return n;
+}
+
+static bool SameWire(wireByte_t *a, uint32_t na, wireByte_t *b, uint32_t nb)
+{
+    if(na != nb)
+    {
+        printf("  length %u != %u\n", na, nb);
+        return false;
+    }
+    for(uint32_t i = 0; i < na; i++)
+    {
+        if(a[i].byte != b[i].byte || a[i].dc != b[i].dc)
+        {
+            printf("  byte %u: %02x/dc%u != %02x/dc%u\n", i, a[i].byte, a[i].dc, b[i].byte, b[i].dc);
+            return false;
+        }
+    }
+    return true;
+}
+
+static wireByte_t Got[2 * MAX_FRAMES], Expected[2 * MAX_FRAMES];
+
+/*
+ * Minimal ILI9341 as the driver sets it up, decoding the captured bytes into a screen
+ *  - 0x2B sets the page range, screen x mirrored; 0x2A the column range, screen y
+ *  - 0x2C writes pixels high byte first, down each column, then to the next page (one screen x to the left)
+ *  - The ranges persist like the controller's, the driver's window cache relies on that
+ */
+typedef uint16_t screen_t[MAX_SCREEN_X + 1][MAX_SCREEN_Y + 1];
+
+static struct {
+    uint8_t command;
+    uint8_t args[4];
+    uint32_t argCount;
+    uint16_t pageStart, pageEnd, columnStart, columnEnd;
+    uint32_t pixel;
+    bool haveHigh;
+    uint8_t high;
+} Panel;
+
+static screen_t NewScreen, OldScreen;
+
+static void PanelDecode(screen_t screen)
+{
+    uint32_t n = WireBytes(Got);
+    for(uint32_t i = 0; i < n; i++)
+    {
+        uint8_t b = Got[i].byte;
+        if(Got[i].dc == 0)
+        {
+            Panel.command = b;
+            Panel.argCount = 0;
+            Panel.pixel = 0;
+            Panel.haveHigh = false;
+            continue;
+        }
+
+        if(Panel.command == 0x2A || Panel.command == 0x2B)
+        {
+            CHECK(Panel.argCount < 4);
+            Panel.args[Panel.argCount++] = b;
+            if(Panel.argCount == 4)
+            {
+                uint16_t start = (Panel.args[0] << 8) | Panel.args[1];
+                uint16_t end = (Panel.args[2] << 8) | Panel.args[3];
+                if(Panel.command == 0x2B)
+                {
+                    Panel.pageStart = start;
+                    Panel.pageEnd = end;
+                }
+                else
+                {
+                    Panel.columnStart = start;
+                    Panel.columnEnd = end;
+                }
+            }
+        }
+        else if(Panel.command == 0x2C)
+        {
+            if(!Panel.haveHigh)
+            {
+                Panel.high = b;
+                Panel.haveHigh = true;
+                continue;
+            }
+            uint32_t columns = Panel.columnEnd - Panel.columnStart + 1;
+            uint32_t page = Panel.pageStart + Panel.pixel / columns;
+            uint32_t column = Panel.columnStart + Panel.pixel % columns;
+            CHECK(page <= Panel.pageEnd && page <= MAX_SCREEN_X && column <= MAX_SCREEN_Y);
+            screen[MAX_SCREEN_X - page][column] = (Panel.high << 8) | b;
+            Panel.pixel++;
+            Panel.haveHigh = false;
+        }
+    }
+    ResetCapture();
+}
+
+/*
+ * A burst goes out as 16-bit frames, high byte first, and leaves SSI0 in 8-bit mode
+ */
+static void TestStreamByteOrder(void)
+{
+    const wireByte_t expected[] = { {0x12,1}, {0x34,1}, {0xF8,1}, {0x1F,1}, {0xF8,1}, {0x1F,1}, {0xF8,1}, {0x1F,1} };
+
+    ResetCapture();
+    LCD_StreamStart();
+    LCD_StreamColor(0x1234);
+    LCD_StreamFill(0xF81F, 3);
+    LCD_StreamEnd();
+
+    CHECK(NumberOfFrames == 4);
+    for(uint32_t i = 0; i < NumberOfFrames; i++)
+    {
+        CHECK(Frames[i].bits == 16);
+    }
+    uint32_t n = WireBytes(Got);
+    CHECK(SameWire(Got, n, (wireByte_t *)expected, sizeof(expected) / sizeof(expected[0])));
+    CHECK((HostSSI0_CR0 & SSI_CR0_DSS_M) == 7);
+    CHECK(PinCS == 1);
+}
+
+/*
+ * A streamed rectangle is byte for byte what the old per-pixel driver sent, commands stay 8-bit
+ */
+static void TestRectangleMatchesLegacy(void)
+{
+    ResetCapture();
+    LCD_DrawRectangle(10, 20, 7, 5, 0xABCD);
+
+    for(uint32_t i = 0; i < NumberOfFrames; i++)
+    {
+        CHECK(Frames[i].dc == 1 || Frames[i].bits == 8);
+    }
+    uint32_t n = WireBytes(Got);
+    uint32_t m = LegacyRectangle(Expected, 10, 20, 7, 5, 0xABCD);
+    CHECK(SameWire(Got, n, Expected, m));
+}
+
+/*
+ * Single pixel pushes stay two 8-bit writes and match the streamed bytes
+ *  - The window is cached from the last test, so only 0x2C goes out before the pixels
+ */
+static void TestPushColorMatchesStream(void)
+{
+    ResetCapture();
+    LCD_SetAddress(10, 20, 16, 24);
+    for(int i = 0; i < 35; i++)
+    {
+        LCD_PushColor(0xABCD);
+    }
+    LCD_EndCommand();
+
+    for(uint32_t i = 0; i < NumberOfFrames; i++)
+    {
+        CHECK(Frames[i].bits == 8);
+    }
+    uint32_t n = WireBytes(Got);
+    uint32_t m = LegacyRectangle(Expected, 10, 20, 7, 5, 0xABCD);
+    CHECK(SameWire(Got, n, &Expected[10], m - 10));         // skips the two cached ranges
+}
+
+/*
+ * LCD_TextBg puts every pixel where the old path put it: the box in the background color,
+ * then PutChar's LCD_SetPoint for each set bit of each glyph
+ *  - Catches the last character first, right edge first column order of LCD_DrawGlyphs
+ */
+static void TestTextBgMatchesPutChar(void)
+{
+    const char text[] = "Ab1%";
+    const uint16_t x = 100, y = 40, fg = 0xF81F, bg = 0x07E0;
+    uint16_t width = (sizeof(text) - 1) * 8;
+
+    for(uint32_t i = 0; i <= MAX_SCREEN_X; i++)
+    {
+        for(uint32_t j = 0; j <= MAX_SCREEN_Y; j++)
+        {
+            NewScreen[i][j] = OldScreen[i][j] = 0x0001;
+        }
+    }
+    for(uint32_t i = x; i < x + width; i++)
+    {
+        for(uint32_t j = y; j < y + 16; j++)
+        {
+            OldScreen[i][j] = bg;
+        }
+    }
+
+    ResetCapture();
+    LCD_TextBg(x, y, (uint8_t *)text, fg, bg);
+    PanelDecode(NewScreen);
+
+    for(uint32_t c = 0; c < sizeof(text) - 1; c++)
+    {
+        PutChar(x + c * 8, y, text[c], fg);
+        PanelDecode(OldScreen);
+    }
+
+    for(uint32_t i = 0; i <= MAX_SCREEN_X; i++)
+    {
+        for(uint32_t j = 0; j <= MAX_SCREEN_Y; j++)
+        {
+            if(NewScreen[i][j] != OldScreen[i][j])
+            {
+                printf("  pixel %u,%u: %04x != %04x\n", i, j, NewScreen[i][j], OldScreen[i][j]);
+                CHECK(NewScreen[i][j] == OldScreen[i][j]);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    LCD_ClockChanged(SysCtlClockGet());
+    TestStreamByteOrder();
+    TestRectangleMatchesLegacy();
+    TestPushColorMatchesStream();
+    TestTextBgMatchesPutChar();
+    printf("test_lcd_wire: PASS\n");
+    return 0;
+}
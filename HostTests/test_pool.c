@@ -0,0 +1,177 @@
+/**
+ * test_pool.c
+ * Host test for G8RTOS_Pool.c
+ *  - Critical sections are one pthread mutex, so host threads contend the way threads and ISRs do on target
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "G8RTOS_Pool.h"
+
+/*********************************************** Host Stubs ***************************************************************************/
+
+static pthread_mutex_t CriticalLock = PTHREAD_MUTEX_INITIALIZER;
+
+int32_t StartCriticalSection()
+{
+    pthread_mutex_lock(&CriticalLock);
+    return 0;
+}
+
+void EndCriticalSection(int32_t IBit_State)
+{
+    (void)IBit_State;
+    pthread_mutex_unlock(&CriticalLock);
+}
+
+/*********************************************** Host Stubs ***************************************************************************/
+
+
+#define NUM_BLOCKS      8
+#define BLOCK_SIZE      12
+#define NUM_WORKERS     12
+#define ITERATIONS      200000
+
+#define CHECK(cond) do { if(!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } } while(0)
+
+G8RTOS_POOL_STORAGE(blocks, BLOCK_SIZE, NUM_BLOCKS);
+static pool_t Pool;
+
+static uint32_t FreeListLength(pool_t *pool)
+{
+    uint32_t n = 0;
+    for(void **block = pool->freeList; block != 0 && n <= pool->numBlocks; block = *block)
+    {
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Allocates until empty, then checks every block is distinct and the next allocation fails
+ */
+static void TestExhaustion(void)
+{
+    void *taken[NUM_BLOCKS];
+    CHECK(G8RTOS_InitPool(&Pool, blocks, BLOCK_SIZE, NUM_BLOCKS) == NO_ERROR);
+
+    for(int i = 0; i < NUM_BLOCKS; i++)
+    {
+        taken[i] = G8RTOS_PoolAlloc(&Pool);
+        CHECK(taken[i] != 0);
+        for(int j = 0; j < i; j++)
+        {
+            CHECK(taken[i] != taken[j]);
+        }
+    }
+    CHECK(G8RTOS_PoolAlloc(&Pool) == 0);
+    CHECK(Pool.failedAllocations == 1);
+    CHECK(Pool.peakInUse == NUM_BLOCKS);
+
+    for(int i = 0; i < NUM_BLOCKS; i++)
+    {
+        CHECK(G8RTOS_PoolFree(&Pool, taken[i]) == NO_ERROR);
+    }
+    CHECK(Pool.inUse == 0);
+    CHECK(FreeListLength(&Pool) == NUM_BLOCKS);
+}
+
+/*
+ * A second free and foreign pointers are rejected without touching the free list or stats
+ */
+static void TestBadFrees(void)
+{
+    CHECK(G8RTOS_InitPool(&Pool, blocks, BLOCK_SIZE, NUM_BLOCKS) == NO_ERROR);
+
+    void *a = G8RTOS_PoolAlloc(&Pool);
+    void *b = G8RTOS_PoolAlloc(&Pool);
+    CHECK(G8RTOS_PoolFree(&Pool, a) == NO_ERROR);
+    CHECK(G8RTOS_PoolFree(&Pool, a) == POOL_DOUBLE_FREE);
+    CHECK(Pool.inUse == 1);
+    CHECK(FreeListLength(&Pool) == NUM_BLOCKS - 1);
+
+    uint32_t outside;
+    CHECK(G8RTOS_PoolFree(&Pool, &outside) == POOL_INVALID);
+    CHECK(G8RTOS_PoolFree(&Pool, (uint8_t *)b + 4) == POOL_INVALID);
+    CHECK(G8RTOS_PoolFree(&Pool, b) == NO_ERROR);
+    CHECK(Pool.inUse == 0);
+    CHECK(FreeListLength(&Pool) == NUM_BLOCKS);
+}
+
+/*
+ * Worker: takes blocks, stamps them with its id, checks nobody else wrote them, gives them back
+ */
+static uint32_t Successes[NUM_WORKERS];
+
+static void *Worker(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    unsigned seed = id;
+
+    for(uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        uint32_t *block = G8RTOS_PoolAlloc(&Pool);
+        if(block == 0)
+        {
+            continue;
+        }
+        Successes[id]++;
+
+        for(int w = 0; w < BLOCK_SIZE / 4; w++)
+        {
+            block[w] = id;
+        }
+        if(rand_r(&seed) % 4 == 0)
+        {
+            sched_yield();                  // hold it across a switch now and then
+        }
+        for(int w = 0; w < BLOCK_SIZE / 4; w++)
+        {
+            CHECK(block[w] == id);
+        }
+        CHECK(G8RTOS_PoolFree(&Pool, block) == NO_ERROR);
+    }
+    return 0;
+}
+
+/*
+ * More workers than blocks hammer the pool, then the stats and free list must add up
+ */
+static void TestContention(void)
+{
+    pthread_t workers[NUM_WORKERS];
+    CHECK(G8RTOS_InitPool(&Pool, blocks, BLOCK_SIZE, NUM_BLOCKS) == NO_ERROR);
+
+    for(uint32_t i = 0; i < NUM_WORKERS; i++)
+    {
+        CHECK(pthread_create(&workers[i], 0, Worker, (void *)(uintptr_t)i) == 0);
+    }
+
+    uint32_t total = 0;
+    for(uint32_t i = 0; i < NUM_WORKERS; i++)
+    {
+        pthread_join(workers[i], 0);
+        total += Successes[i];
+    }
+
+    pool_t stats;
+    G8RTOS_GetPoolStats(&Pool, &stats);
+    CHECK(stats.inUse == 0);
+    CHECK(stats.allocations == total);
+    CHECK(stats.allocations + stats.failedAllocations == NUM_WORKERS * ITERATIONS);
+    CHECK(stats.peakInUse <= NUM_BLOCKS);
+    CHECK(FreeListLength(&Pool) == NUM_BLOCKS);
+    printf("  %u allocations, %u failed, peak %u of %u\n",
+           stats.allocations, stats.failedAllocations, stats.peakInUse, NUM_BLOCKS);
+}
+
+int main(void)
+{
+    TestExhaustion();
+    TestBadFrees();
+    TestContention();
+    printf("test_pool: PASS\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+"""
+ProfileReport.py
+
+Turns the PC samples printed by G8RTOS_DumpProfile into a flat profile and a
+per-thread profile, resolving addresses against the CCS .out the board runs.
+
+The board prints captures on UART0 (the debug USB port) at every game over.
+Save the console to a file, or let this script read the port itself:
+
+    python ProfileReport.py Debug/SmileRacer.out console.log
+    python ProfileReport.py Debug/SmileRacer.out --port /dev/ttyACM0 --captures 3
+
+Every capture in the input is added up. --lines also lists the hottest source
+lines, which tells a delay loop apart from a busy-wait in the same function.
+"""
+
+import argparse
+import bisect
+import sys
+from collections import Counter, defaultdict
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+ISR_ID = 0           # PROFILER_ISR_ID, the sampler interrupted another handler
+TOP = 15             # rows shown per table
+
+
+def load_functions(elf):
+    """Sorted (start, end, name) of every function symbol, thumb bit cleared."""
+    functions = []
+    for section in elf.iter_sections():
+        if not isinstance(section, SymbolTableSection):
+            continue
+        for symbol in section.iter_symbols():
+            if symbol['st_info']['type'] != 'STT_FUNC' or symbol['st_value'] == 0:
+                continue
+            start = symbol['st_value'] & ~1
+            functions.append((start, start + max(symbol['st_size'], 2), symbol.name))
+    functions.sort()
+    return functions
+
+
+def load_lines(elf):
+    """Sorted (address, "file:line") rows of the DWARF line tables."""
+    rows = []
+    if not elf.has_dwarf_info():
+        return rows
+    dwarf = elf.get_dwarf_info()
+    for cu in dwarf.iter_CUs():
+        program = dwarf.line_program_for_CU(cu)
+        if program is None:
+            continue
+        files = program['file_entry']
+        for entry in program.get_entries():
+            state = entry.state
+            if state is None or state.end_sequence:
+                continue
+            index = state.file - 1 if program.header['version'] < 5 else state.file
+            name = files[index].name.decode() if 0 <= index < len(files) else '?'
+            rows.append((state.address, '%s:%d' % (name, state.line)))
+    rows.sort()
+    return rows
+
+
+def resolve_function(functions, starts, pc):
+    i = bisect.bisect_right(starts, pc) - 1
+    if i >= 0 and functions[i][0] <= pc < functions[i][1]:
+        return functions[i][2]
+    return '0x%08x' % pc
+
+
+def resolve_line(lines, addresses, pc):
+    i = bisect.bisect_right(addresses, pc) - 1
+    return lines[i][1] if i >= 0 else '0x%08x' % pc
+
+
+def read_captures(stream, limit):
+    """Yields (thread names, samples) for every complete capture in the stream."""
+    names = {}
+    samples = []
+    inside = False
+    found = 0
+    for raw in stream:
+        line = raw.decode(errors='replace') if isinstance(raw, bytes) else raw
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == 'profile' and len(words) > 1 and words[1] == 'begin':
+            names, samples, inside = {}, [], True
+        elif words[0] == 'profile' and len(words) > 1 and words[1] == 'end' and inside:
+            inside = False
+            found += 1
+            yield names, samples
+            if limit and found >= limit:
+                return
+        elif inside and words[0] == 'thread' and len(words) >= 2:
+            names[int(words[1], 16)] = ' '.join(words[2:]) or '?'
+        elif inside and len(words) == 2:
+            try:
+                samples.append((int(words[0], 16), int(words[1], 16)))
+            except ValueError:
+                pass
+
+
+def print_table(title, counter, total):
+    print(title)
+    print('  %8s %6s  %s' % ('samples', '%', 'where'))
+    for where, count in counter.most_common(TOP):
+        print('  %8d %5.1f%%  %s' % (count, 100.0 * count / total, where))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Symbolize G8RTOS PC samples.')
+    parser.add_argument('elf', help='the .out the board was flashed with')
+    parser.add_argument('log', nargs='?', help='saved console output, stdin if omitted')
+    parser.add_argument('--port', help='read the console from a serial port instead')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--captures', type=int, default=0, help='stop after this many captures')
+    parser.add_argument('--lines', action='store_true', help='also list the hottest source lines')
+    args = parser.parse_args()
+
+    with open(args.elf, 'rb') as f:
+        elf = ELFFile(f)
+        functions = load_functions(elf)
+        lines = load_lines(elf) if args.lines else []
+    starts = [f[0] for f in functions]
+    addresses = [l[0] for l in lines]
+
+    if args.port:
+        from serial import Serial
+        stream = Serial(port=args.port, baudrate=args.baud)
+    elif args.log:
+        stream = open(args.log, 'r', errors='replace')
+    else:
+        stream = sys.stdin
+
+    names = {ISR_ID: '(interrupts)'}
+    flat = Counter()
+    by_line = Counter()
+    per_thread = defaultdict(Counter)
+    captures = 0
+    for capture_names, samples in read_captures(stream, args.captures):
+        captures += 1
+        names.update(capture_names)
+        for pc, thread in samples:
+            function = resolve_function(functions, starts, pc)
+            flat[function] += 1
+            per_thread[thread][function] += 1
+            if args.lines:
+                by_line[resolve_line(lines, addresses, pc)] += 1
+
+    total = sum(flat.values())
+    if total == 0:
+        sys.exit('no samples found')
+
+    print('%d samples from %d captures\n' % (total, captures))
+    print_table('Flat profile', flat, total)
+    if args.lines:
+        print_table('Hottest lines', by_line, total)
+    for thread, counter in sorted(per_thread.items(), key=lambda t: -sum(t[1].values())):
+        count = sum(counter.values())
+        title = 'Thread %s (0x%x): %d samples, %.1f%%' % (
+            names.get(thread, '?'), thread, count, 100.0 * count / total)
+        print_table(title, counter, count)
+
+
+if __name__ == '__main__':
+    main()
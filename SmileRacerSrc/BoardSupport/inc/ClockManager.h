@@ -0,0 +1,54 @@
+/*
+ * ClockManager.h
+ */
+
+#ifndef BOARDSUPPORT_CLOCKMANAGER_H_
+#define BOARDSUPPORT_CLOCKMANAGER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/************************************ Defines *******************************************/
+
+/* Drivers that can be told about a clock change */
+#define MAX_CLOCK_CALLBACKS 8
+
+/* System clock settings, all from the PLL on the 16 MHz crystal */
+typedef enum {
+    CLOCK_20MHZ,        // Game Over screen
+    CLOCK_50MHZ,
+    CLOCK_80MHZ         // Fastest the TM4C123 runs, used during gameplay
+} clockSpeed_t;
+
+/************************************ Defines *******************************************/
+
+/************************************ Public Functions  *******************************************/
+
+/*
+ * Registers a driver to be told about clock changes
+ *  - Callbacks run in registration order with interrupts off, right after the PLL locks
+ *  - They recompute dividers from the new clock, they must not block
+ *  - Bytes still in a FIFO while the PLL relocks go out at the wrong rate, switch between transfers
+ *  - Registering the same callback twice is ignored
+ * Param "callback": Called with the new clock in Hz
+ * Returns: false if the table is full
+ */
+bool ClockManager_Register(void (*callback)(uint32_t clockHz));
+
+/*
+ * Switches the PLL divider and tells every registered driver
+ *  - Does nothing if the clock is already at that speed
+ *  - Waits for the LCD's async queue to drain, from a thread it blocks, elsewhere it polls
+ *  - Takes as long as the PLL needs to lock, with interrupts off
+ * Param "speed": New system clock
+ */
+void ClockManager_SetSpeed(clockSpeed_t speed);
+
+/*
+ * Returns the current clock setting
+ */
+clockSpeed_t ClockManager_GetSpeed(void);
+
+/************************************ Public Functions  *******************************************/
+
+#endif /* BOARDSUPPORT_CLOCKMANAGER_H_ */
@@ -9,6 +9,9 @@ void InitializeLEDI2C(uint32_t moduleNumber);
 // Initializes I2C module for sensor BoosterPack
 void InitializeSensorI2C();
 
+// Waits for the last command to finish, past the window where the busy bit still reads idle
+void I2CWaitMasterDone(uint32_t moduleNumber);
+
 // Set slave address
 void SetSlaveAddress(uint32_t moduleNumber, uint16_t address);
 
@@ -107,6 +107,20 @@ inline void PutChar( uint16_t Xpos, uint16_t Ypos, uint8_t ASCI, uint16_t charCo
 *******************************************************************************/
 void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str,uint16_t Color);
 
+/******************************************************************************
+* Function Name  : LCD_TextBg
+* Description    : Displays the string over a solid background
+* Input          : - Xpos: Horizontal coordinate
+*                  - Ypos: Vertical coordinate
+*                  - str: Displayed string
+*                  - charColor: Character color
+*                  - bkColor: Background color
+* Output         : None
+* Return         : None
+* Attention      : Overwrites the whole 8x16 cell of every character, no erase needed first
+*******************************************************************************/
+void LCD_TextBg(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t charColor, uint16_t bkColor);
+
 /*******************************************************************************
 * Function Name  : LCD_Write_Data_Only
 * Description    : Data writing to the LCD controller
@@ -117,6 +131,16 @@ void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str,uint16_t Color);
 *******************************************************************************/
 inline void LCD_Write_Data_Only(uint8_t data);
 
+/*******************************************************************************
+* Function Name  : LCD_EndCommand
+* Description    : Ends current command with NOP command
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+inline void LCD_EndCommand(void);
+
 /*******************************************************************************
 * Function Name  : LCD_Clear
 * Description    : Fill the screen as the specified color
@@ -241,13 +265,43 @@ inline void LCD_SetCursor(uint16_t Xpos, uint16_t Ypos );
 *******************************************************************************/
 void LCD_Init(bool usingTP);
 
+/*******************************************************************************
+* Function Name  : LCD_InitStart
+* Description    : Configures LCD Control lines and starts the init sequence
+* Input          : bool usingTP: determines whether or not to enable TP interrupt
+* Output         : None
+* Return         : None
+* Attention      : Needs the system clock set, call LCD_InitStep until it returns true
+*******************************************************************************/
+void LCD_InitStart(bool usingTP);
+
+/*******************************************************************************
+* Function Name  : LCD_InitStep
+* Description    : Sends the init commands whose datasheet wait has passed
+* Input          : None
+* Output         : None
+* Return         : true once the LCD is ready to draw
+* Attention      : Never blocks
+*******************************************************************************/
+bool LCD_InitStep(void);
+
+/*******************************************************************************
+* Function Name  : LCD_ClockChanged
+* Description    : Recomputes the SPI bit rate divider for a new system clock
+* Input          : clockHz: new system clock
+* Output         : None
+* Return         : None
+* Attention      : Clock manager callback
+*******************************************************************************/
+void LCD_ClockChanged(uint32_t clockHz);
+
 /*******************************************************************************
 * Function Name  : LCD_SetAddress
 * Description    : Sets the draw area of the LCD
 * Input          : uin16_t x1, y1, x2, y2: Represents the start and end LCD address for drawing
 * Output         : None
 * Return         : None
-* Attention      : None
+* Attention      : Call LCD_WaitIdle first if async requests may be queued
 *******************************************************************************/
 void LCD_SetAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2);
 
@@ -261,6 +315,117 @@ void LCD_SetAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2);
 *******************************************************************************/
 void LCD_PushColor(uint16_t color);
 
+/*******************************************************************************
+* Function Name  : LCD_StreamStart
+* Description    : Starts a burst of pixel data after LCD_SetAddress
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : Holds CS low until LCD_StreamEnd
+*******************************************************************************/
+void LCD_StreamStart(void);
+
+/*******************************************************************************
+* Function Name  : LCD_StreamColor
+* Description    : Queues one pixel of a burst
+* Input          : uint16_t color: 16 bit value of the color to output
+* Output         : None
+* Return         : None
+* Attention      : Call between LCD_StreamStart and LCD_StreamEnd
+*******************************************************************************/
+void LCD_StreamColor(uint16_t color);
+
+/*******************************************************************************
+* Function Name  : LCD_StreamFill
+* Description    : Queues "count" pixels of one color
+* Input          : uint16_t color: 16 bit value of the color to output, count: number of pixels
+* Output         : None
+* Return         : None
+* Attention      : Call between LCD_StreamStart and LCD_StreamEnd
+*******************************************************************************/
+void LCD_StreamFill(uint16_t color, uint32_t count);
+
+/*******************************************************************************
+* Function Name  : LCD_StreamEnd
+* Description    : Ends a burst once the FIFO has drained
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+void LCD_StreamEnd(void);
+
+/*******************************************************************************
+* Function Name  : LCD_InitDMA
+* Description    : Brings up the uDMA backend for the async calls
+* Input          : None
+* Output         : None
+* Return         : true if the backend is up, the async calls draw synchronously otherwise
+* Attention      : Call after G8RTOS_Init and before G8RTOS_Launch
+*******************************************************************************/
+bool LCD_InitDMA(void);
+
+/*******************************************************************************
+* Function Name  : LCD_DrawRectangleAsync
+* Description    : Queues a rectangle fill and returns before it is drawn
+* Input          : x, y, w, h, color
+* Output         : None
+* Return         : None
+* Attention      : Thread use only, serialize with the other LCD calls as usual
+*******************************************************************************/
+void LCD_DrawRectangleAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+/*******************************************************************************
+* Function Name  : LCD_BlitAsync
+* Description    : Queues a copy of an RGB565 pixel buffer and returns before it is drawn
+* Input          : x, y, w, h: window, pixels: w * h colors, row by row
+* Output         : None
+* Return         : None
+* Attention      : Keep the buffer unchanged until LCD_WaitIdle returns
+*******************************************************************************/
+void LCD_BlitAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
+
+/*******************************************************************************
+* Function Name  : LCD_IsIdle
+* Description    : Tells whether any async request is queued or on the wire
+* Input          : None
+* Output         : None
+* Return         : true when SSI0 is free of DMA transfers
+* Attention      : Only stays true while the caller keeps others from queueing, e.g. in a critical section
+*******************************************************************************/
+bool LCD_IsIdle(void);
+
+/*******************************************************************************
+* Function Name  : LCD_WaitIdle
+* Description    : Blocks until every queued async request has been drawn
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : The drawing calls start with it, so synchronous drawing never overlaps a transfer.
+*                  Safe from handlers and critical sections, there it polls instead of blocking
+*******************************************************************************/
+void LCD_WaitIdle(void);
+
+/*******************************************************************************
+* Function Name  : LCD_GetWindowBytesSaved
+* Description    : Returns the SPI bytes the window cache skipped since the last reset of the count
+* Input          : None
+* Output         : None
+* Return         : Bytes not sent
+* Attention      : None
+*******************************************************************************/
+uint32_t LCD_GetWindowBytesSaved(void);
+
+/*******************************************************************************
+* Function Name  : LCD_ResetWindowStats
+* Description    : Clears the window cache's saved byte count
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+void LCD_ResetWindowStats(void);
+
 /*******************************************************************************
  * Function Name  : TP_ReadXY
  * Description    : Obtain X and Y touch coordinates
@@ -22,9 +22,23 @@
 #include "driverlib/interrupt.h"
 #include "driverlib/timer.h"
 #include "driverlib/fpu.h"
+#include "ILI9341_Lib.h"
+#include "BoardSupport/inc/ClockManager.h"
+#include "G8RTOS_Scheduler.h"
 
 
 
+/*
+ * Recomputes the baud rate divisors of the game input UART and the console after a clock change
+ */
+static void ConsoleClockChanged(uint32_t clockHz)
+{
+    UARTConfigSetExpClk(UART1_BASE, clockHz, 115200,
+                            (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+                             UART_CONFIG_PAR_NONE));
+    UARTStdioConfig(0, 115200, clockHz);
+}
+
 static void InitConsole(void) // configures UART2
 {
     /*
@@ -64,6 +78,21 @@ static void InitConsole(void) // configures UART2
                              UART_CONFIG_PAR_NONE));
     IntEnable(INT_UART1);
     UARTIntEnable(UART1_BASE, UART_INT_RX | UART_INT_RT);
+
+    //
+    // UART0 on the debug USB port is the text console for UARTprintf,
+    // UART1 stays with the game input.
+    //
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+
+    GPIOPinConfigure(GPIO_PA0_U0RX);
+    GPIOPinConfigure(GPIO_PA1_U0TX);
+    GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+
+    UARTStdioConfig(0, 115200, SysCtlClockGet());
+
+    ClockManager_Register(ConsoleClockChanged);
 }
 
 static void EnableSwitchInterrupt(void)
@@ -98,12 +127,17 @@ bool InitializeBoard(void)
 {
     // WatchDog timer is off by default (will generate errors in debug window unless clock gating is enabled to it)
 
-    // Set clock speed higher using the PLL (50 MHz)
-    SysCtlClockSet(SYSCTL_SYSDIV_4|SYSCTL_USE_PLL|SYSCTL_XTAL_16MHZ|SYSCTL_OSC_MAIN);
+    // Run at full speed from the PLL (80 MHz), the kernel follows every clock change
+    ClockManager_Register(G8RTOS_ClockChanged);
+    ClockManager_SetSpeed(CLOCK_80MHZ);
+
+    // Start the LCD, the rest of the board is set up during its power-up waits
+    LCD_InitStart(false);
 
     // Initialize I2C for the LEDs and the Sensor BooserPack
     InitializeLEDI2C(I2C0_BASE);
     InitializeSensorI2C();
+    LCD_InitStep();
 
     // Initialize and Test OPT3001 Digital Ambient Light Sensor (ALS)
     //sensorOpt3001Enable(true);
@@ -133,6 +167,7 @@ bool InitializeBoard(void)
 
     // Initialize Console UART from TIVA SDK
     InitConsole();
+    LCD_InitStep();
 
     // Initialize RGB LEDs
  //   InitializeRGBLEDs();
@@ -143,6 +178,9 @@ bool InitializeBoard(void)
     //Configure timer used to debounce
     ConfigureTimer();
 
+    // Finish the LCD, only the datasheet waits are left
+    while (!LCD_InitStep());
+
     return true;
 }
 
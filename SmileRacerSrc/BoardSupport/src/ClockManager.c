@@ -0,0 +1,107 @@
+/*
+ * ClockManager.c
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "BoardSupport/inc/ClockManager.h"
+#include "BoardSupport/inc/ILI9341_Lib.h"
+#include "driverlib/sysctl.h"
+#include "G8RTOS_CriticalSection.h"
+
+/************************************  Private Variables  *******************************************/
+
+/*
+ * SysCtlClockSet divider for each clockSpeed_t, the PLL runs at 200 MHz after its divide by 2
+ */
+static const uint32_t SystemDividers[] = {
+    SYSCTL_SYSDIV_10,       // CLOCK_20MHZ
+    SYSCTL_SYSDIV_4,        // CLOCK_50MHZ
+    SYSCTL_SYSDIV_2_5       // CLOCK_80MHZ
+};
+
+/*
+ * Registered drivers, in registration order
+ */
+static void (*ClockCallbacks[MAX_CLOCK_CALLBACKS])(uint32_t clockHz);
+static uint32_t NumberOfClockCallbacks;
+
+/*
+ * Current setting, valid once ClockManager_SetSpeed has run
+ */
+static clockSpeed_t CurrentSpeed;
+static bool SpeedSet;
+
+/************************************  Private Variables  *******************************************/
+
+/************************************  Public Functions  *******************************************/
+
+/*
+ * Registers a driver to be told about clock changes
+ */
+bool ClockManager_Register(void (*callback)(uint32_t clockHz))
+{
+    int32_t IBit_State = StartCriticalSection();
+    for (uint32_t i = 0; i < NumberOfClockCallbacks; i++)
+    {
+        if (ClockCallbacks[i] == callback)
+        {
+            EndCriticalSection(IBit_State);
+            return true;
+        }
+    }
+    if (NumberOfClockCallbacks >= MAX_CLOCK_CALLBACKS)
+    {
+        EndCriticalSection(IBit_State);
+        return false;
+    }
+    ClockCallbacks[NumberOfClockCallbacks++] = callback;
+    EndCriticalSection(IBit_State);
+    return true;
+}
+
+/*
+ * Switches the PLL divider and tells every registered driver
+ *  - Waits out queued LCD transfers first, SSI0 is reconfigured under them otherwise
+ *  - All in one critical section so nothing runs with dividers for the old clock
+ */
+void ClockManager_SetSpeed(clockSpeed_t speed)
+{
+    if (SpeedSet && speed == CurrentSpeed)
+    {
+        return;
+    }
+
+    int32_t IBit_State;
+    while (1)
+    {
+        LCD_WaitIdle();
+        IBit_State = StartCriticalSection();
+        if (LCD_IsIdle())               // a thread may have queued one after the wait
+        {
+            break;
+        }
+        EndCriticalSection(IBit_State);
+    }
+
+    SysCtlClockSet(SystemDividers[speed] | SYSCTL_USE_PLL | SYSCTL_XTAL_16MHZ | SYSCTL_OSC_MAIN);
+    CurrentSpeed = speed;
+    SpeedSet = true;
+
+    uint32_t clockHz = SysCtlClockGet();
+    for (uint32_t i = 0; i < NumberOfClockCallbacks; i++)
+    {
+        ClockCallbacks[i](clockHz);
+    }
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Returns the current clock setting
+ */
+clockSpeed_t ClockManager_GetSpeed(void)
+{
+    return CurrentSpeed;
+}
+
+/************************************  Public Functions  *******************************************/
@@ -7,9 +7,32 @@
 #include "inc/hw_i2c.h"
 #include "inc/hw_memmap.h"
 #include "inc/tm4c123gh6pm.h"
+#include "BoardSupport/inc/ClockManager.h"
+#include "BoardSupport/inc/I2CDriver.h"
+#include "G8RTOS_Scheduler.h"
+
+// I2CMasterBusy reads idle for a few cycles after a command is issued
+#define I2C_BUSY_SETTLE_US 1
 
 static uint8_t I2CPeripheralOffset;
 
+// Masters set up so far, their clock dividers follow the system clock
+static uint32_t LEDI2CModule;
+static bool SensorI2CInitialized;
+
+// Recomputes the 400 kHz dividers after a clock change
+static void I2CClockChanged(uint32_t clockHz)
+{
+    if (LEDI2CModule != 0)
+    {
+        I2CMasterInitExpClk(LEDI2CModule, clockHz, true);
+    }
+    if (SensorI2CInitialized)
+    {
+        I2CMasterInitExpClk(I2C1_BASE, clockHz, true);
+    }
+}
+
 void InitializeLEDI2C(uint32_t moduleNumber)
 {
     I2CPeripheralOffset = moduleNumber & 0x0000F000;
@@ -24,6 +47,8 @@ void InitializeLEDI2C(uint32_t moduleNumber)
     GPIOPinTypeI2C(GPIO_PORTB_BASE, GPIO_PIN_3);
 
     I2CMasterInitExpClk(moduleNumber, SysCtlClockGet(), true);
+    LEDI2CModule = moduleNumber;
+    ClockManager_Register(I2CClockChanged);
 }
 
 void InitializeSensorI2C()
@@ -38,6 +63,14 @@ void InitializeSensorI2C()
     GPIOPinTypeI2C(GPIO_PORTA_BASE, GPIO_PIN_7);
 
     I2CMasterInitExpClk(I2C1_BASE, SysCtlClockGet(), true);
+    SensorI2CInitialized = true;
+    ClockManager_Register(I2CClockChanged);
+}
+
+void I2CWaitMasterDone(uint32_t moduleNumber)
+{
+    G8RTOS_DelayUs(I2C_BUSY_SETTLE_US);
+    while(I2CMasterBusy(moduleNumber));
 }
 
 void SetSlaveAddress(uint32_t moduleNumber, uint16_t address)
@@ -68,8 +101,7 @@ void SignalMasterReceive(uint32_t moduleNumber, uint16_t registerAddress, uint16
 {
     I2CMasterDataPut(moduleNumber, registerAddress);
     I2CMasterControl(moduleNumber, I2C_MASTER_CMD_BURST_RECEIVE_START);
-    SysCtlDelay(100);
-    while(I2CMasterBusy(moduleNumber));
+    I2CWaitMasterDone(moduleNumber);
 
     I2CMasterSlaveAddrSet(moduleNumber, slaveAddress, true);
 }
@@ -77,8 +109,7 @@ void SignalMasterReceive(uint32_t moduleNumber, uint16_t registerAddress, uint16
 uint8_t StartReceive(uint32_t moduleNumber)
 {
     I2CMasterControl(moduleNumber, I2C_MASTER_CMD_BURST_RECEIVE_START);
-    SysCtlDelay(100);
-    while(I2CMasterBusy(moduleNumber));
+    I2CWaitMasterDone(moduleNumber);
     uint8_t data = (I2CMasterDataGet(moduleNumber) & 0xFF);
     return data;
 }
@@ -86,8 +117,7 @@ uint8_t StartReceive(uint32_t moduleNumber)
 uint8_t EndReceive(uint32_t moduleNumber)
 {
     I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_BURST_RECEIVE_FINISH);
-    SysCtlDelay(100);
-    while(I2CMasterBusy(I2C1_BASE));
+    I2CWaitMasterDone(I2C1_BASE);
     uint8_t data = (I2CMasterDataGet(I2C1_BASE));
     return data;
 }
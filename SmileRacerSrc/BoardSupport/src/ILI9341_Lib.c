@@ -7,15 +7,19 @@
 #include "AsciiLib.h"
 #include "G8RTOS.h"
 #include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Sections.h"
 
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/ssi.h"
 #include "driverlib/interrupt.h"
+#include "driverlib/udma.h"
 #include "BoardSupport/inc/demo_sysctl.h"
+#include "BoardSupport/inc/ClockManager.h"
 
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "inc/hw_types.h"
 #include "inc/tm4c123gh6pm.h"
 
@@ -24,6 +28,124 @@
 #define ADC_X_INVERSE .000565
 #define ADC_Y_INVERSE .000560
 
+/* Datasheet minimum waits (ILI9341 v1.11) */
+#define LCD_RESET_PULSE_US      20      // RESX low >= 10 us
+#define LCD_RESET_WAIT_MS       5       // reset to first command
+#define LCD_SLEEP_OUT_WAIT_MS   120     // reset to Sleep Out
+
+/* Init table entry: command, flags | parameter count, parameters, then the wait bytes the flags ask for */
+#define LCD_INIT_COUNT_M        0x1F
+#define LCD_INIT_SINCE_RESET    0x40    // hold the command until this many ms after the last reset
+#define LCD_INIT_DELAY          0x80    // wait this many ms after the command
+
+#define LCD_CMD_SWRESET         0x01
+
+/* SPI bit rate, capped at the SSI master's limit of half the system clock */
+#define LCD_SSI_BITRATE         12000000
+
+/* Async drawing: queued requests, pixels per DMA half (the uDMA limit) and the SSI0 IRQ priority */
+#define LCD_MAX_REQUESTS        16
+#define LCD_DMA_CHUNK           1024
+#define LCD_DMA_PRIORITY        2
+
+/************************************  Private Types  *******************************************/
+
+/*
+ * One queued fill or blit, alive from LCD_QueueRequest until its DMA transfer completes
+ */
+typedef struct lcdRequest_t {
+    uint16_t x, y, w, h;
+    uint16_t color;                 // fill color, also the fixed DMA source of a fill
+    const uint16_t *pixels;         // blit source, 0 for a fill
+    struct lcdRequest_t *next;
+} lcdRequest_t;
+
+/************************************  Private Types  *******************************************/
+
+/************************************  Private Variables  *******************************************/
+
+/*
+ * ILI9341 power-up sequence, sent in order by LCD_InitStep
+ */
+static const uint8_t LCD_InitCommands[] = {
+    LCD_CMD_SWRESET, LCD_INIT_DELAY | 0, LCD_RESET_WAIT_MS,
+    0xEF, 3, 0x03, 0x80, 0x02,
+    0xCF, 3, 0x00, 0xC1, 0x30,                      // Power Control B
+    0xED, 4, 0x64, 0x03, 0x12, 0x81,                // Power On Sequence Control
+    0xE8, 3, 0x85, 0x00, 0x78,                      // Driver Timing Control A
+    0xCB, 5, 0x39, 0x2C, 0x00, 0x34, 0x02,          // Power Control A
+    0xF7, 1, 0x20,                                  // Pump Ratio Control
+    0xEA, 2, 0x00, 0x00,                            // Driver Timing Control B
+    0xC0, 1, 0x23,                                  // Power Control, VRH[5:0]
+    0xC1, 1, 0x10,                                  // Power Control, SAP[2:0];BT[3:0]
+    0xC5, 2, 0x3E, 0x28,                            // VCM Control
+    0xC7, 1, 0x86,                                  // VCM Control 2
+    0x36, 1, 0x48,                                  // Memory Access Control
+    0x3A, 1, 0x55,                                  // Pixel Format
+    0xB1, 2, 0x00, 0x18,                            // Frame Ratio Control, Standard RGB Color
+    0xB6, 3, 0x08, 0x82, 0x27,                      // Display Function Control
+    0xF2, 1, 0x00,                                  // 3Gamma Function Disable
+    0x26, 1, 0x01,                                  // Gamma Curve Selected
+    0xE0, 15, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08,   // Positive Gamma Correction
+              0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03,
+              0x0E, 0x09, 0x00,
+    0xE1, 15, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07,   // Negative Gamma Correction
+              0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C,
+              0x31, 0x36, 0x0F,
+    0x11, LCD_INIT_SINCE_RESET | LCD_INIT_DELAY | 0, LCD_SLEEP_OUT_WAIT_MS, LCD_RESET_WAIT_MS,   // Sleep Out
+    0x29, 0,                                        // Display On
+};
+
+/*
+ * Next table entry to send, the wait it is held for and the time of the last reset
+ */
+static const uint8_t *InitNext;
+static uint64_t InitWaitUntil;
+static uint64_t InitResetTime;
+
+/*
+ * uDMA channel control table, primary and alternate structures of all 32 channels
+ *  - The controller needs it 1024-byte aligned
+ */
+#pragma DATA_ALIGN(DMAControlTable, 1024)
+static tDMAControlTable DMAControlTable[64];
+
+/*
+ * Request blocks and the queue, ActiveRequest is the one on the wire and heads the queue
+ *  - Guarded by RequestLock, RequestDone is broadcast whenever a request completes
+ */
+G8RTOS_POOL_STORAGE(requestBlocks, sizeof(lcdRequest_t), LCD_MAX_REQUESTS);
+static pool_t RequestPool;
+static lcdRequest_t *ActiveRequest;
+static lcdRequest_t *RequestTail;
+static semaphore_t RequestLock;
+static condition_t RequestDone;
+static bool DMAReady;
+
+/*
+ * Transfer state shared with the SSI0 top half
+ *  - Next source pixel, pixels not yet handed to a DMA half, and whether the source advances
+ */
+static const uint16_t *DMANext;
+static volatile uint32_t DMARemaining;
+static bool DMAIncrement;
+static volatile bool DMADone;
+
+/*
+ * Last page (0x2B) and column (0x2A) ranges sent to the controller, in its coordinates
+ *  - Cleared by a reset, an unchanged range is not sent again
+ */
+static uint16_t PageStart, PageEnd;
+static uint16_t ColumnStart, ColumnEnd;
+static bool WindowValid;
+
+/*
+ * Command and parameter bytes the window cache kept off the bus
+ */
+static uint32_t WindowBytesSaved;
+
+/************************************  Private Variables  *******************************************/
+
 /************************************  Private Functions  *******************************************/
 
 /*
@@ -58,15 +180,12 @@ static void WriteTP_CS(uint8_t value)
 }
 
 /*
- * Delay x ms
+ * Spins until G8RTOS_GetTimeUs reaches "time"
+ *  - Only for waits too short to be worth returning from LCD_InitStep
  */
-static void Delay(unsigned long interval)
+static void WaitUntilUs(uint64_t time)
 {
-    while(interval > 0)
-    {
-        SysDelay(50000);
-        interval--;
-    }
+    while(G8RTOS_GetTimeUs() < time);
 }
 
 /*******************************************************************************
@@ -93,11 +212,9 @@ static void LCD_initSPI()
     GPIOPinConfigure(GPIO_PA5_SSI0TX);
     GPIOPinTypeSSI(GPIO_PORTA_BASE, GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_2);
 
-    // Configure SPI Master mode
-    SSIConfigSetExpClk(SSI0_BASE, SysCtlClockGet(), SSI_FRF_MOTO_MODE_3, SSI_MODE_MASTER, 12000000, 8);
-
-    // Enable SPI
-    SSIEnable(SSI0_BASE);
+    // Configure SPI Master mode and enable it
+    LCD_ClockChanged(SysCtlClockGet());
+    ClockManager_Register(LCD_ClockChanged);
 
     // Enable TFT CS and TP CS
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
@@ -110,26 +227,322 @@ static void LCD_initSPI()
 
 /*******************************************************************************
  * Function Name  : LCD_reset
- * Description    : Resets LCD
+ * Description    : Pulses the LCD hardware reset line
  * Input          : None
  * Output         : None
  * Return         : None
- * Attention      : Uses PD0 for reset
+ * Attention      : Uses PB0 for reset, the caller waits LCD_RESET_WAIT_MS before the first command
  *******************************************************************************/
 static void LCD_reset()
 {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
 
-    // Set PD0 as output
+    // Set PB0 as output
     GPIOPinTypeGPIOOutput(GPIO_PORTB_BASE, GPIO_PIN_0);
 
-    // Set pin high, low, and high
-    GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0, GPIO_PIN_0);
-    Delay(100);
+    // Pull low for at least the datasheet's 10 us, then release
     GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0, 0);
-    Delay(100);
+    WaitUntilUs(G8RTOS_GetTimeUs() + LCD_RESET_PULSE_US);
     GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0, GPIO_PIN_0);
 }
+
+/*******************************************************************************
+ * Function Name  : LCD_SendInitCommand
+ * Description    : Sends one entry of the init table
+ * Input          : cmd: command index, args: its parameters, count: number of parameters
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+static void LCD_SendInitCommand(uint8_t cmd, const uint8_t *args, uint8_t count)
+{
+    LCD_WriteIndex(cmd);
+    for(uint8_t i = 0; i < count; i++)
+    {
+        LCD_WriteData(args[i]);
+    }
+}
+/*******************************************************************************
+ * Function Name  : LCD_SendWindow
+ * Description    : Sends the column/page window and starts a memory write
+ * Input          : uin16_t x1, y1, x2, y2: Represents the start and end LCD address for drawing
+ * Output         : None
+ * Return         : None
+ * Attention      : Skips a range the controller already has, 0x2C always restarts at the window's corner
+ *******************************************************************************/
+static void LCD_SendWindow(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    uint16_t new_x1 = MAX_SCREEN_X - x2;
+    uint16_t new_x2 = MAX_SCREEN_X - x1;
+
+    if (WindowValid && new_x1 == PageStart && new_x2 == PageEnd)
+    {
+        WindowBytesSaved += 5;
+    }
+    else
+    {
+        LCD_WriteIndex(0x2B);
+        LCD_WriteData(new_x1>>8);
+        LCD_WriteData(new_x1);
+        LCD_WriteData(new_x2>>8);
+        LCD_WriteData(new_x2);
+        PageStart = new_x1;
+        PageEnd = new_x2;
+    }
+
+    if (WindowValid && y1 == ColumnStart && y2 == ColumnEnd)
+    {
+        WindowBytesSaved += 5;
+    }
+    else
+    {
+        LCD_WriteIndex(0x2A);
+        LCD_WriteData(y1>>8);
+        LCD_WriteData(y1);
+        LCD_WriteData(y2>>8);
+        LCD_WriteData(y2);
+        ColumnStart = y1;
+        ColumnEnd = y2;
+    }
+
+    WindowValid = true;
+    LCD_WriteIndex(0x2C);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_SetFrameBits
+ * Description    : Changes the SSI0 data frame size
+ * Input          : bits: 8 for commands, 16 for RGB565 pixels
+ * Output         : None
+ * Return         : None
+ * Attention      : Drains the FIFO first, the frame size may only change with SSI0 disabled
+ *******************************************************************************/
+RAMFUNC static void LCD_SetFrameBits(uint32_t bits)
+{
+    if((SSI0_CR0_R & SSI_CR0_DSS_M) == bits - 1)
+    {
+        return;
+    }
+
+    while(SSIBusy(SSI0_BASE));
+    SSIDisable(SSI0_BASE);
+    SSI0_CR0_R = (SSI0_CR0_R & ~SSI_CR0_DSS_M) | (bits - 1);
+    SSIEnable(SSI0_BASE);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMALoad
+ * Description    : Hands the next chunk of the transfer to one DMA half
+ * Input          : half: UDMA_PRI_SELECT or UDMA_ALT_SELECT
+ * Output         : None
+ * Return         : None
+ * Attention      : A half with nothing left is stopped so the channel ends after the other one
+ *******************************************************************************/
+RAMFUNC static void LCD_DMALoad(uint32_t half)
+{
+    uint32_t count = (DMARemaining < LCD_DMA_CHUNK) ? DMARemaining : LCD_DMA_CHUNK;
+    uint32_t mode = (count != 0) ? UDMA_MODE_PINGPONG : UDMA_MODE_STOP;
+
+    uDMAChannelTransferSet(UDMA_CHANNEL_SSI0TX | half, mode, (void *)DMANext, (void *)&SSI0_DR_R, count ? count : 1);
+    DMARemaining -= count;
+    if(DMAIncrement)
+    {
+        DMANext += count;
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_StartRequest
+ * Description    : Sends a request's window and starts its DMA transfer
+ * Input          : req: request at the head of the queue
+ * Output         : None
+ * Return         : None
+ * Attention      : Fills repeat one source pixel, blits walk the pixel buffer
+ *******************************************************************************/
+static void LCD_StartRequest(lcdRequest_t *req)
+{
+    LCD_SendWindow(req->x, req->y, req->x + req->w - 1, req->y + req->h - 1);
+    LCD_StreamStart();
+
+    DMAIncrement = (req->pixels != 0);
+    DMANext = DMAIncrement ? req->pixels : &req->color;
+    DMARemaining = (uint32_t)req->w * req->h;
+    DMADone = false;
+
+    uint32_t control = UDMA_SIZE_16 | UDMA_DST_INC_NONE | UDMA_ARB_4 |
+                       (DMAIncrement ? UDMA_SRC_INC_16 : UDMA_SRC_INC_NONE);
+    uDMAChannelControlSet(UDMA_CHANNEL_SSI0TX | UDMA_PRI_SELECT, control);
+    uDMAChannelControlSet(UDMA_CHANNEL_SSI0TX | UDMA_ALT_SELECT, control);
+    LCD_DMALoad(UDMA_PRI_SELECT);
+    LCD_DMALoad(UDMA_ALT_SELECT);
+
+    uDMAChannelEnable(UDMA_CHANNEL_SSI0TX);
+    SSIDMAEnable(SSI0_BASE, SSI_DMA_TX);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMARefill
+ * Description    : Reloads whichever DMA half has stopped while pixels remain
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Called with the SSI0 interrupt unable to preempt, it does the same
+ *******************************************************************************/
+RAMFUNC static void LCD_DMARefill(void)
+{
+    if(DMARemaining != 0 && uDMAChannelModeGet(UDMA_CHANNEL_SSI0TX | UDMA_PRI_SELECT) == UDMA_MODE_STOP)
+    {
+        LCD_DMALoad(UDMA_PRI_SELECT);
+    }
+    if(DMARemaining != 0 && uDMAChannelModeGet(UDMA_CHANNEL_SSI0TX | UDMA_ALT_SELECT) == UDMA_MODE_STOP)
+    {
+        LCD_DMALoad(UDMA_ALT_SELECT);
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMATopHalf
+ * Description    : SSI0 interrupt, a DMA half finished
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Refills the stopped half, turns SSI0 TX DMA off once the channel is done
+ *******************************************************************************/
+RAMFUNC static void LCD_DMATopHalf(void)
+{
+    if(!uDMAChannelIsEnabled(UDMA_CHANNEL_SSI0TX))
+    {
+        SSIDMADisable(SSI0_BASE, SSI_DMA_TX);       // keeps the done request from firing again
+        DMADone = true;
+        return;
+    }
+    LCD_DMARefill();
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMAPollQueue
+ * Description    : Draws every queued request to the end without the SSI0 interrupt
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : For handlers and critical sections, which cannot block on the queue.
+ *                  Starts and polls each remaining request in order, so a synchronous draw
+ *                  after it lands on top. Leaves SSI0 idle in 8-bit mode with CS high
+ *******************************************************************************/
+static void LCD_DMAPollQueue(void)
+{
+    int32_t IBit_State = StartCriticalSection();
+    while(ActiveRequest != 0)
+    {
+        while(uDMAChannelIsEnabled(UDMA_CHANNEL_SSI0TX))
+        {
+            LCD_DMARefill();
+        }
+        SSIDMADisable(SSI0_BASE, SSI_DMA_TX);
+        LCD_StreamEnd();
+        LCD_EndCommand();
+
+        lcdRequest_t *done = ActiveRequest;
+        ActiveRequest = done->next;
+        G8RTOS_PoolFree(&RequestPool, done);
+        if(ActiveRequest != 0)
+        {
+            LCD_StartRequest(ActiveRequest);
+        }
+    }
+    RequestTail = 0;
+    DMADone = false;                                // a stale top half or bottom half finds nothing to retire
+    IntPendClear(INT_SSI0);
+    G8RTOS_BroadcastCondition(&RequestDone);
+    EndCriticalSection(IBit_State);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_DMABottomHalf
+ * Description    : Finishes a completed request and starts the next queued one
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Runs on the deferred worker, posts for finished chunks and for requests
+ *                  LCD_DMAPollQueue already retired are ignored
+ *******************************************************************************/
+static void LCD_DMABottomHalf(void)
+{
+    if(!DMADone)
+    {
+        return;
+    }
+
+    G8RTOS_WaitSemaphore(&RequestLock);
+    int32_t IBit_State = StartCriticalSection();    // LCD_DMAPollQueue may drain the queue from a handler
+    if(!DMADone || ActiveRequest == 0)
+    {
+        EndCriticalSection(IBit_State);
+        G8RTOS_SignalSemaphore(&RequestLock);
+        return;
+    }
+
+    LCD_StreamEnd();
+    LCD_EndCommand();
+
+    lcdRequest_t *done = ActiveRequest;
+    ActiveRequest = done->next;
+    if(ActiveRequest == 0)
+    {
+        RequestTail = 0;
+    }
+    G8RTOS_PoolFree(&RequestPool, done);
+
+    if(ActiveRequest != 0)
+    {
+        LCD_StartRequest(ActiveRequest);
+    }
+    EndCriticalSection(IBit_State);
+    G8RTOS_BroadcastCondition(&RequestDone);
+    G8RTOS_SignalSemaphore(&RequestLock);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_QueueRequest
+ * Description    : Queues a fill or blit, starting it right away if the queue is empty
+ * Input          : x, y, w, h: window, color: fill color, pixels: blit source or 0
+ * Output         : None
+ * Return         : None
+ * Attention      : Blocks only while all LCD_MAX_REQUESTS blocks are queued
+ *******************************************************************************/
+static void LCD_QueueRequest(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color, const uint16_t *pixels)
+{
+    G8RTOS_WaitSemaphore(&RequestLock);
+
+    lcdRequest_t *req;
+    while((req = G8RTOS_PoolAlloc(&RequestPool)) == 0)
+    {
+        G8RTOS_WaitCondition(&RequestDone, &RequestLock);
+    }
+    req->x = x;
+    req->y = y;
+    req->w = w;
+    req->h = h;
+    req->color = color;
+    req->pixels = pixels;
+    req->next = 0;
+
+    int32_t IBit_State = StartCriticalSection();    // LCD_DMAPollQueue may drain the queue from a handler
+    if(RequestTail == 0)
+    {
+        ActiveRequest = req;
+        RequestTail = req;
+        LCD_StartRequest(req);
+    }
+    else
+    {
+        RequestTail->next = req;
+        RequestTail = req;
+    }
+    EndCriticalSection(IBit_State);
+
+    G8RTOS_SignalSemaphore(&RequestLock);
+}
 /************************************  End of Private Functions  *******************************************/
 
 
@@ -178,6 +591,38 @@ inline void LCD_EndCommand(void)
     LCD_WriteIndex(0x00); //NOP
 }
 
+/******************************************************************************
+ * Function Name  : LCD_DrawGlyphs
+ * Description    : Draws a run of characters on one line as a single window
+ * Input          : - Xpos, Ypos: top left of the first character
+ *                  - str: characters, count: how many of them
+ *                  - charColor, bkColor: glyph and background colors
+ * Output         : None
+ * Return         : None
+ * Attention      : The controller fills the window column by column from its right edge,
+ *                  so the glyphs are streamed last character first, rightmost bit first
+ *******************************************************************************/
+static void LCD_DrawGlyphs(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t count, uint16_t charColor, uint16_t bkColor)
+{
+    uint8_t buffer[16];
+
+    LCD_SetAddress(Xpos, Ypos, Xpos + count * 8 - 1, Ypos + 15);
+    LCD_StreamStart();
+    for (int16_t c = count - 1; c >= 0; c--)
+    {
+        GetASCIICode(buffer, str[c]);  /* get font data */
+        for (int8_t j = 7; j >= 0; j--)
+        {
+            for (uint8_t i = 0; i < 16; i++)
+            {
+                LCD_StreamColor(((buffer[i] >> (7 - j)) & 0x01) ? charColor : bkColor);
+            }
+        }
+    }
+    LCD_StreamEnd();
+    LCD_EndCommand();
+}
+
 /******************************************************************************
  * Function Name  : GUI_Text
  * Description    : Displays the string
@@ -191,28 +636,70 @@ inline void LCD_EndCommand(void)
  *******************************************************************************/
 void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color)
 {
-    uint8_t TempChar;
-
-    do
+    LCD_WaitIdle();
+    PROFILE_SCOPE("LCD_Text")
     {
-        TempChar = *str++;
-        PutChar( Xpos, Ypos, TempChar, Color);
-        if( Xpos < MAX_SCREEN_X - 8)
-        {
-            Xpos += 8;
-        }
-        else if ( Ypos < MAX_SCREEN_Y - 16)
+        uint8_t TempChar;
+
+        do
         {
-            Xpos = 0;
-            Ypos += 16;
+            TempChar = *str++;
+            PutChar( Xpos, Ypos, TempChar, Color);
+            if( Xpos < MAX_SCREEN_X - 8)
+            {
+                Xpos += 8;
+            }
+            else if ( Ypos < MAX_SCREEN_Y - 16)
+            {
+                Xpos = 0;
+                Ypos += 16;
+            }
+            else
+            {
+                Xpos = 0;
+                Ypos = 0;
+            }
         }
-        else
+        while ( *str != 0 );
+    }
+}
+
+/******************************************************************************
+ * Function Name  : LCD_TextBg
+ * Description    : Displays the string over a solid background
+ * Input          : - Xpos: Horizontal coordinate
+ *                  - Ypos: Vertical coordinate
+ *                  - str: Displayed string
+ *                  - charColor: Character color
+ *                  - bkColor: Background color
+ * Output         : None
+ * Return         : None
+ * Attention      : One window per line, wraps the same way as LCD_Text
+ *******************************************************************************/
+void LCD_TextBg(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t charColor, uint16_t bkColor)
+{
+    LCD_WaitIdle();
+    PROFILE_SCOPE("LCD_TextBg")
+    {
+        while (*str != 0)
         {
+            // as many characters as fit on this line
+            uint16_t count = 0;
+            while (str[count] != 0 && Xpos + (count + 1) * 8 <= MAX_SCREEN_X)
+            {
+                count++;
+            }
+
+            if (count != 0)
+            {
+                LCD_DrawGlyphs(Xpos, Ypos, str, count, charColor, bkColor);
+                str += count;
+            }
+
             Xpos = 0;
-            Ypos = 0;
+            Ypos = (Ypos < MAX_SCREEN_Y - 16) ? Ypos + 16 : 0;
         }
     }
-    while ( *str != 0 );
 }
 
 /******************************************************************************
@@ -226,6 +713,7 @@ void LCD_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color)
  *******************************************************************************/
 void LCD_SetPoint(uint16_t Xpos, uint16_t Ypos, uint16_t color)
 {
+    LCD_WaitIdle();
     LCD_SetAddress(Xpos, Ypos, Xpos, Ypos);
     LCD_PushColor(color);
     LCD_EndCommand();
@@ -255,7 +743,7 @@ inline void LCD_Write_Data_Only(uint8_t data)
  * Return         : None
  * Attention      : None
  *******************************************************************************/
-inline void LCD_WriteData(uint8_t data)
+RAMFUNC inline void LCD_WriteData(uint8_t data)
 {
     WriteTFT_CS(0);
     WriteTFT_DC(1);
@@ -263,9 +751,8 @@ inline void LCD_WriteData(uint8_t data)
 
     while(SSIBusy(SSI0_BASE));
 
-    WriteTFT_CS(1);
+    WriteTFT_CS(1);           // the GPIO writes outlast the 40 ns CS high time (tCHW), no delay needed
     WriteTFT_DC(1);
-    SysDelay(20);
 }
 
 /*******************************************************************************
@@ -289,7 +776,7 @@ inline uint8_t LCD_ReadReg(uint8_t LCD_Reg)
  * Return         : None
  * Attention      : None
  *******************************************************************************/
-inline void LCD_WriteIndex(uint8_t index)
+RAMFUNC inline void LCD_WriteIndex(uint8_t index)
 {
     /* SPI write data */
     WriteTFT_CS(0);
@@ -297,9 +784,8 @@ inline void LCD_WriteIndex(uint8_t index)
     SSI0_DR_R = index;
     while(SSIBusy(SSI0_BASE));
 
-    WriteTFT_CS(1);
+    WriteTFT_CS(1);           // the GPIO writes outlast the 40 ns CS high time (tCHW), no delay needed
     WriteTFT_DC(1);
-    SysDelay(20);
 }
 
 
@@ -369,14 +855,15 @@ inline void LCD_SetCursor(uint16_t Xpos, uint16_t Ypos)
 }
 
 /*******************************************************************************
- * Function Name  : LCD_Init
- * Description    : Configures LCD Control lines, sets whole screen black
+ * Function Name  : LCD_InitStart
+ * Description    : Configures LCD Control lines and starts the init sequence
  * Input          : bool usingTP: determines whether or not to enable TP interrupt
  * Output         : None
  * Return         : None
- * Attention      : None
+ * Attention      : Call LCD_InitStep until it returns true before drawing
  *******************************************************************************/
-void LCD_Init(bool usingTP){
+void LCD_InitStart(bool usingTP)
+{
     LCD_initSPI();
     WriteTFT_CS(1);
     WriteTFT_DC(1);
@@ -392,139 +879,99 @@ void LCD_Init(bool usingTP){
             GPIOIntTypeSet(GPIO_PORTB_BASE, GPIO_PIN_4, GPIO_FALLING_EDGE);
             GPIOIntEnable(GPIO_PORTB_BASE, GPIO_INT_PIN_4);
             IntEnable(INT_GPIOB);
-            Delay(500);
         }
     LCD_reset();
+    WindowValid = false;
+
+    uint64_t now = G8RTOS_GetTimeUs();
+    InitNext = LCD_InitCommands;
+    InitResetTime = now;
+    InitWaitUntil = now + LCD_RESET_WAIT_MS * 1000;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_InitStep
+ * Description    : Runs the init table up to the next wait that has not passed
+ * Input          : None
+ * Output         : None
+ * Return         : true once the whole table has been sent
+ * Attention      : Never blocks, other board init can run between calls
+ *******************************************************************************/
+bool LCD_InitStep(void)
+{
+    const uint8_t *end = LCD_InitCommands + sizeof(LCD_InitCommands);
+
+    while (InitNext < end)
+    {
+        uint64_t now = G8RTOS_GetTimeUs();
+        if (now < InitWaitUntil)
+        {
+            return false;
+        }
 
-    LCD_WriteIndex(0x01);
-    Delay(1000);
-
-    LCD_WriteIndex(0xEF);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x80);
-    LCD_WriteData(0x02);
-
-    // Power Control B
-    LCD_WriteIndex(0xCF);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0xC1);
-    LCD_WriteData(0x30);
-
-    // Power On Sequence Control
-    LCD_WriteIndex(0xED);
-    LCD_WriteData(0x64);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x12);
-    LCD_WriteData(0x81);
-
-    // Driver Timing Control A
-    LCD_WriteIndex(0xE8);
-    LCD_WriteData(0x85);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x78);
-
-    // Power Control A
-    LCD_WriteIndex(0xCB);
-    LCD_WriteData(0x39);
-    LCD_WriteData(0x2C);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x34);
-    LCD_WriteData(0x02);
-
-    // Pump Ratio Control
-    LCD_WriteIndex(0xF7);
-    LCD_WriteData(0x20);
-
-    // Driver Timing Control B
-    LCD_WriteIndex(0xEA);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x00);
-
-    //Power Control, VRH[5:0]
-    LCD_WriteIndex(0xC0);
-    LCD_WriteData(0x23);
-
-    //POWER CONTROL,SAP[2:0];BT[3:0]
-    LCD_WriteIndex(0xC1);
-    LCD_WriteData(0x10);
-
-    //VCM CONTROL
-    LCD_WriteIndex(0xC5);
-    LCD_WriteData(0x3E);
-    LCD_WriteData(0x28);
-
-    //VCM CONTROL 2
-    LCD_WriteIndex(0xC7);
-    LCD_WriteData(0x86);
-
-    //MEMORY ACCESS CONTROL
-    LCD_WriteIndex(0x36);
-    LCD_WriteData(0x48);
-
-    //PIXEL FORMAT
-    LCD_WriteIndex(0x3A);
-    LCD_WriteData(0x55);
-
-    //FRAME RATIO CONTROL, STANDARD RGB COLOR
-    LCD_WriteIndex(0xB1);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x18);
-
-    //DISPLAY FUNCTION CONTROL
-    LCD_WriteIndex(0xB6);
-    LCD_WriteData(0x08);
-    LCD_WriteData(0x82);
-    LCD_WriteData(0x27);
-
-    //3GAMMA FUNCTION DISABLE
-    LCD_WriteIndex(0xF2);
-    LCD_WriteData(0x00);
-
-    //GAMMA CURVE SELECTED
-    LCD_WriteIndex(0x26);
-    LCD_WriteData(0x01);
-
-    //POSITIVE GAMMA CORRECTION
-    LCD_WriteIndex(0xE0);
-    LCD_WriteData(0x0F);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0x2B);
-    LCD_WriteData(0x0C);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x08);
-    LCD_WriteData(0x4E);
-    LCD_WriteData(0xF1);
-    LCD_WriteData(0x37);
-    LCD_WriteData(0x07);
-    LCD_WriteData(0x10);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x09);
-    LCD_WriteData(0x00);
-
-    //NEGATIVE GAMMA CORRECTION
-    LCD_WriteIndex(0xE1);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x14);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x11);
-    LCD_WriteData(0x07);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0xC1);
-    LCD_WriteData(0x48);
-    LCD_WriteData(0x08);
-    LCD_WriteData(0x0F);
-    LCD_WriteData(0x0C);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0x36);
-    LCD_WriteData(0x0F);
-
-    LCD_WriteIndex(0x11);
-    Delay(120);
-
-    LCD_WriteIndex(0x29);
+        uint8_t cmd = InitNext[0];
+        uint8_t flags = InitNext[1];
+        uint8_t count = flags & LCD_INIT_COUNT_M;
+        const uint8_t *args = &InitNext[2];
+        const uint8_t *next = args + count;
 
+        // Some commands may only go out a while after the reset
+        if (flags & LCD_INIT_SINCE_RESET)
+        {
+            uint64_t allowed = InitResetTime + (uint64_t)(*next++) * 1000;
+            if (now < allowed)
+            {
+                InitWaitUntil = allowed;
+                return false;
+            }
+        }
+
+        LCD_SendInitCommand(cmd, args, count);
+        now = G8RTOS_GetTimeUs();
+        if (cmd == LCD_CMD_SWRESET)
+        {
+            InitResetTime = now;
+        }
+        if (flags & LCD_INIT_DELAY)
+        {
+            InitWaitUntil = now + (uint64_t)(*next++) * 1000;
+        }
+        InitNext = next;
+    }
+
+    // the last entry's wait still has to pass before the first frame
+    return (G8RTOS_GetTimeUs() >= InitWaitUntil);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_Init
+ * Description    : Configures LCD Control lines and runs the whole init sequence
+ * Input          : bool usingTP: determines whether or not to enable TP interrupt
+ * Output         : None
+ * Return         : None
+ * Attention      : Blocks for the datasheet waits, about 130 ms
+ *******************************************************************************/
+void LCD_Init(bool usingTP){
+    LCD_InitStart(usingTP);
+    while (!LCD_InitStep());
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_ClockChanged
+ * Description    : Recomputes the SPI bit rate divider for a new system clock
+ * Input          : clockHz: new system clock
+ * Output         : None
+ * Return         : None
+ * Attention      : Registered with the clock manager by LCD_InitStart, which drains the async queue first
+ *******************************************************************************/
+void LCD_ClockChanged(uint32_t clockHz)
+{
+    uint32_t bitRate = (clockHz / 2 < LCD_SSI_BITRATE) ? clockHz / 2 : LCD_SSI_BITRATE;
+
+    while(SSIBusy(SSI0_BASE));
+    SSIDisable(SSI0_BASE);
+    SSIConfigSetExpClk(SSI0_BASE, clockHz, SSI_FRF_MOTO_MODE_3, SSI_MODE_MASTER, bitRate, 8);
+    SSIEnable(SSI0_BASE);
 }
 
 /*******************************************************************************
@@ -533,23 +980,11 @@ void LCD_Init(bool usingTP){
 * Input          : uin16_t x1, y1, x2, y2: Represents the start and end LCD address for drawing
 * Output         : None
 * Return         : None
-* Attention      : None
+* Attention      : Call LCD_WaitIdle first if async requests may be queued, the drawing calls do
 *******************************************************************************/
 void LCD_SetAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2)//set coordinate for print or other function
 {
-    uint16_t new_x1 = MAX_SCREEN_X - x2;
-    uint16_t new_x2 = MAX_SCREEN_X - x1;
-    LCD_WriteIndex(0x2B);
-    LCD_WriteData(new_x1>>8);
-    LCD_WriteData(new_x1);
-    LCD_WriteData(new_x2>>8);
-    LCD_WriteData(new_x2);
-    LCD_WriteIndex(0x2A);
-    LCD_WriteData(y1>>8);
-    LCD_WriteData(y1);
-    LCD_WriteData(y2>>8);
-    LCD_WriteData(y2);
-    LCD_WriteIndex(0x2C);
+    LCD_SendWindow(x1, y1, x2, y2);
 }
 
 /*******************************************************************************
@@ -560,12 +995,73 @@ void LCD_SetAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2)//set coordi
 * Return         : None
 * Attention      : None
 *******************************************************************************/
-void LCD_PushColor(uint16_t color)
+RAMFUNC void LCD_PushColor(uint16_t color)
 {
-    LCD_WriteData(color>>8);
+    LCD_WriteData(color>>8);        // one pixel, cheaper as two 8-bit writes than two frame size changes
     LCD_WriteData(color);
 }
 
+/*******************************************************************************
+* Function Name  : LCD_StreamStart
+* Description    : Starts a burst of pixel data after LCD_SetAddress
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : CS stays low and SSI0 sends 16-bit frames until LCD_StreamEnd
+*******************************************************************************/
+RAMFUNC void LCD_StreamStart(void)
+{
+    LCD_SetFrameBits(16);
+    WriteTFT_DC(1);
+    WriteTFT_CS(0);
+}
+
+/*******************************************************************************
+* Function Name  : LCD_StreamColor
+* Description    : Queues one pixel of a burst
+* Input          : uint16_t color: 16 bit value of the color to output
+* Output         : None
+* Return         : None
+* Attention      : Only waits for room in the TX FIFO, not for the pixel to go out
+*******************************************************************************/
+RAMFUNC void LCD_StreamColor(uint16_t color)
+{
+    while(!(SSI0_SR_R & SSI_SR_TNF));
+    SSI0_DR_R = color;                              /* Write D15..D0, MSB first like two byte writes */
+}
+
+/*******************************************************************************
+* Function Name  : LCD_StreamFill
+* Description    : Queues "count" pixels of one color
+* Input          : uint16_t color: 16 bit value of the color to output, count: number of pixels
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+RAMFUNC void LCD_StreamFill(uint16_t color, uint32_t count)
+{
+    while(count--)
+    {
+        while(!(SSI0_SR_R & SSI_SR_TNF));
+        SSI0_DR_R = color;
+    }
+}
+
+/*******************************************************************************
+* Function Name  : LCD_StreamEnd
+* Description    : Ends a burst once the FIFO has drained
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : Puts SSI0 back to 8-bit frames for commands
+*******************************************************************************/
+RAMFUNC void LCD_StreamEnd(void)
+{
+    while(SSIBusy(SSI0_BASE));
+    WriteTFT_CS(1);
+    LCD_SetFrameBits(8);
+}
+
 /*******************************************************************************
 * Function Name  : LCD_Clear
 * Description    : Fill the screen as the specified color
@@ -574,15 +1070,17 @@ void LCD_PushColor(uint16_t color)
 * Return         : None
 * Attention      : None
 *******************************************************************************/
-void LCD_Clear(uint16_t color)
+RAMFUNC void LCD_Clear(uint16_t color)
 {
-    LCD_SetAddress(0, 0, MAX_SCREEN_X, MAX_SCREEN_Y);
-    int count = MAX_SCREEN_X * MAX_SCREEN_Y;
-    for (int i = 0; i < count; i++)
+    LCD_WaitIdle();
+    PROFILE_SCOPE("LCD_Clear")
     {
-        LCD_PushColor(color);
+        LCD_SetAddress(0, 0, MAX_SCREEN_X, MAX_SCREEN_Y);
+        LCD_StreamStart();
+        LCD_StreamFill(color, MAX_SCREEN_X * MAX_SCREEN_Y);
+        LCD_StreamEnd();
+        LCD_EndCommand();
     }
-    LCD_EndCommand();
 }
 
 /*******************************************************************************
@@ -593,16 +1091,157 @@ void LCD_Clear(uint16_t color)
  * Return         : None
  * Attention      : None
  *******************************************************************************/
-void LCD_DrawRectangle(uint16_t x,uint16_t y,uint16_t w,uint16_t h,uint16_t color)
+RAMFUNC void LCD_DrawRectangle(uint16_t x,uint16_t y,uint16_t w,uint16_t h,uint16_t color)
 {
-    LCD_SetAddress(x, y, x+w-1, y+h-1);
+    LCD_WaitIdle();
+    PROFILE_SCOPE("LCD_DrawRect")
+    {
+        LCD_SetAddress(x, y, x+w-1, y+h-1);
+        LCD_StreamStart();
+        LCD_StreamFill(color, (uint32_t)w * h);
+        LCD_StreamEnd();
+        LCD_EndCommand();
+    }
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_InitDMA
+ * Description    : Brings up the uDMA backend for the async calls
+ * Input          : None
+ * Output         : None
+ * Return         : true if the backend is up, the async calls draw synchronously otherwise
+ * Attention      : Call after G8RTOS_Init and before G8RTOS_Launch
+ *******************************************************************************/
+bool LCD_InitDMA(void)
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+    uDMAEnable();
+    uDMAControlBaseSet(DMAControlTable);
+
+    uDMAChannelAssign(UDMA_CH11_SSI0TX);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_SSI0TX, UDMA_ATTR_ALL);
+
+    G8RTOS_InitPool(&RequestPool, requestBlocks, sizeof(lcdRequest_t), LCD_MAX_REQUESTS);
+    G8RTOS_InitSemaphore(&RequestLock, 1);
+    G8RTOS_InitCondition(&RequestDone);
+
+    DMAReady = (G8RTOS_AddDeferredEvent(LCD_DMATopHalf, LCD_DMABottomHalf, LCD_DMA_PRIORITY, INT_SSI0) == NO_ERROR);
+    return DMAReady;
+}
 
-    uint32_t count = w * h;
-    for(int i = 0; i < count; i++)
+/*******************************************************************************
+ * Function Name  : LCD_DrawRectangleAsync
+ * Description    : Queues a rectangle fill and returns before it is drawn
+ * Input          : x, y, w, h, color
+ * Output         : None
+ * Return         : None
+ * Attention      : Draws it right away when the DMA backend is not up or the caller cannot block
+ *******************************************************************************/
+void LCD_DrawRectangleAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    if(!DMAReady || !G8RTOS_CanBlock())
     {
-        LCD_PushColor(color);
+        LCD_DrawRectangle(x, y, w, h, color);
+        return;
     }
-    LCD_EndCommand();
+    LCD_QueueRequest(x, y, w, h, color, 0);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_BlitAsync
+ * Description    : Queues a copy of an RGB565 pixel buffer and returns before it is drawn
+ * Input          : x, y, w, h: window, pixels: w * h colors, row by row
+ * Output         : None
+ * Return         : None
+ * Attention      : The buffer is read by DMA, keep it unchanged until LCD_WaitIdle returns
+ *******************************************************************************/
+void LCD_BlitAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels)
+{
+    if(!DMAReady || !G8RTOS_CanBlock())
+    {
+        LCD_WaitIdle();
+        LCD_SetAddress(x, y, x+w-1, y+h-1);
+        LCD_StreamStart();
+        for(uint32_t i = 0; i < (uint32_t)w * h; i++)
+        {
+            LCD_StreamColor(pixels[i]);
+        }
+        LCD_StreamEnd();
+        LCD_EndCommand();
+        return;
+    }
+    LCD_QueueRequest(x, y, w, h, 0, pixels);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_IsIdle
+ * Description    : Tells whether any async request is queued or on the wire
+ * Input          : None
+ * Output         : None
+ * Return         : true when SSI0 is free of DMA transfers
+ * Attention      : Only stays true while the caller keeps others from queueing, e.g. in a critical section
+ *******************************************************************************/
+bool LCD_IsIdle(void)
+{
+    return (ActiveRequest == 0);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_WaitIdle
+ * Description    : Blocks until every queued async request has been drawn
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : Returns at once when nothing is queued. From a handler, a critical section or
+ *                  before G8RTOS_Launch it cannot block, it starts and polls every queued
+ *                  request to its end instead
+ *******************************************************************************/
+void LCD_WaitIdle(void)
+{
+    if(ActiveRequest == 0)
+    {
+        return;
+    }
+
+    if(!G8RTOS_CanBlock())
+    {
+        LCD_DMAPollQueue();
+        return;
+    }
+
+    G8RTOS_WaitSemaphore(&RequestLock);
+    while(ActiveRequest != 0)
+    {
+        G8RTOS_WaitCondition(&RequestDone, &RequestLock);
+    }
+    G8RTOS_SignalSemaphore(&RequestLock);
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_GetWindowBytesSaved
+ * Description    : Returns the SPI bytes the window cache skipped since the last reset of the count
+ * Input          : None
+ * Output         : None
+ * Return         : Bytes not sent
+ * Attention      : None
+ *******************************************************************************/
+uint32_t LCD_GetWindowBytesSaved(void)
+{
+    return WindowBytesSaved;
+}
+
+/*******************************************************************************
+ * Function Name  : LCD_ResetWindowStats
+ * Description    : Clears the window cache's saved byte count
+ * Input          : None
+ * Output         : None
+ * Return         : None
+ * Attention      : None
+ *******************************************************************************/
+void LCD_ResetWindowStats(void)
+{
+    WindowBytesSaved = 0;
 }
 
 /*******************************************************************************
@@ -13,11 +13,15 @@
 #include "inc/hw_memmap.h"
 #include "inc/tm4c123gh6pm.h"
 #include "driverlib/interrupt.h"
+#include "G8RTOS_Cooperative.h"
 /*********************************************** Dependencies and Externs *************************************************************/
 
 
 /*********************************************** Defines *********************************************************************/
 
+/* Push button bounce time, the old busy-wait was 600000 SysCtlDelay loops (36 ms at 50 MHz) */
+#define JOYSTICK_DEBOUNCE_MS 36
+
 
 /*********************************************** Public Variables ********************************************************************/
 
@@ -100,11 +104,36 @@ void GetJoystickCoordinates(uint32_t * coordinates)
     ADCSequenceDataGet(ADC0_BASE, 2, coordinates);
 }
 
-void PortEIntHandler(void)
+/*
+ * Finishes the push button debounce outside the interrupt
+ *  - Sleeps out the bounce in the cooperative host, then re-arms the pin interrupt
+ */
+static int32_t ButtonDebounceTask(ctcb_t *task)
 {
-    SysCtlDelay(600000);
+    COOP_BEGIN(task);
+
+    COOP_SLEEP(task, JOYSTICK_DEBOUNCE_MS);
     GPIOIntClear(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
+    GPIOIntEnable(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
     //ButtonFunction();
+
+    COOP_END(task);
+}
+
+/*
+ * Push button interrupt
+ *  - Masks the pin until the debounce task re-arms it, nothing waits here
+ *  - With no room for the task the pin is re-armed right away, undebounced beats dead
+ */
+void PortEIntHandler(void)
+{
+    GPIOIntClear(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
+    GPIOIntDisable(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
+    if(G8RTOS_AddCoopTask(ButtonDebounceTask) != NO_ERROR)
+    {
+        GPIOIntClear(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
+        GPIOIntEnable(GPIO_PORTE_BASE, GPIO_INT_PIN_1);
+    }
 }
 
 /*********************************************** Public Functions *********************************************************************/
@@ -441,8 +441,7 @@ s8 BME280_I2C_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
     SetSlaveAddress(I2C1_BASE, dev_addr);
     I2CMasterDataPut(I2C1_BASE, reg_addr);
     I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_SINGLE_SEND);
-    SysCtlDelay(100);
-    while(I2CMasterBusy(I2C1_BASE));
+    I2CWaitMasterDone(I2C1_BASE);
 
     I2CMasterSlaveAddrSet(I2C1_BASE, dev_addr, true);
 
@@ -457,22 +456,19 @@ s8 BME280_I2C_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
             if (i == 0)
             {
                 I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_BURST_RECEIVE_START);
-                SysCtlDelay(100);
-                while(I2CMasterBusy(I2C1_BASE));
+                I2CWaitMasterDone(I2C1_BASE);
                 *reg_data = (I2CMasterDataGet(I2C1_BASE) & 0xFF);
             }
             if (i == cnt - 1)
             {
                 I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_BURST_RECEIVE_FINISH);
-                SysCtlDelay(100);
-                while(I2CMasterBusy(I2C1_BASE));
+                I2CWaitMasterDone(I2C1_BASE);
                 *reg_data = (I2CMasterDataGet(I2C1_BASE) & 0xFF);
             }
             else
             {
                 I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_BURST_RECEIVE_CONT);
-                SysCtlDelay(100);
-                while(I2CMasterBusy(I2C1_BASE));
+                I2CWaitMasterDone(I2C1_BASE);
                 *reg_data = (I2CMasterDataGet(I2C1_BASE) & 0xFF);
             }
             reg_data--;
@@ -483,8 +479,7 @@ s8 BME280_I2C_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
     else
     {
         I2CMasterControl(I2C1_BASE, I2C_MASTER_CMD_SINGLE_RECEIVE);
-        SysCtlDelay(100);
-        while(I2CMasterBusy(I2C1_BASE));
+        I2CWaitMasterDone(I2C1_BASE);
         *reg_data = (I2CMasterDataGet(I2C1_BASE) & 0xFF);
     }
 
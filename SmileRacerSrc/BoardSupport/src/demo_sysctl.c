@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include "driverlib/sysctl.h"
 #include "BoardSupport/inc/demo_sysctl.h"
+#include "G8RTOS_Scheduler.h"
 
 //*****************************************************************************
 //
@@ -81,10 +82,6 @@ __asm("    .sect \".text:SysDelay\"\n"
 
 void DelayMs (uint32_t ulClockMS)
 {
-	if (ulClockMS == 1)
-	{
-		ulClockMS = 2;
-	}
-	SysDelay((ulClockMS/2)*(SysCtlClockGet() / (3 * 1000)));
+	G8RTOS_DelayMs(ulClockMS);
 }
 
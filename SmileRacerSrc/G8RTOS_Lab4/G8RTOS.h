@@ -11,6 +11,14 @@
 #include "G8RTOS_Scheduler.h"
 #include "G8RTOS_Structures.h"
 #include "G8RTOS_IPC.h"
+#include "G8RTOS_Cooperative.h"
+#include "G8RTOS_Deferred.h"
+#include "G8RTOS_Pool.h"
+#include "G8RTOS_Fault.h"
+#include "G8RTOS_Health.h"
+#include "G8RTOS_SemaphoreStats.h"
+#include "G8RTOS_Profiler.h"
+#include "G8RTOS_Timebase.h"
 
 
 
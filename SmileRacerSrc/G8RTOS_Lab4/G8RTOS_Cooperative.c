@@ -0,0 +1,205 @@
+/**
+ * G8RTOS_Cooperative.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_Cooperative.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_Pool.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Cooperative Task Control Blocks
+ *  - Every stackless task lives in one of these, the host thread's stack is shared by all of them
+ *  - Handed out by CoopTaskPool, alive tasks are linked by nextTask
+ */
+G8RTOS_POOL_STORAGE(coopControlBlocks, sizeof(ctcb_t), MAX_COOP_TASKS);
+static pool_t CoopTaskPool;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Current Number of cooperative tasks alive
+ */
+static uint32_t NumberOfCoopTasks;
+
+/*
+ * Alive tasks, newest first
+ */
+static ctcb_t *CoopTasks;
+
+/*
+ * Signalled when a task is added while the host is idle
+ */
+static semaphore_t CoopTaskAdded;
+
+/*
+ * Set while the host is blocked on CoopTaskAdded
+ */
+static bool CoopHostIdle;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Unlinks an exited task and gives its block back to the pool
+ *  - Searches from the head, a task may have been pushed in front of it during the pass
+ */
+static void RemoveCoopTask(ctcb_t *task)
+{
+    int32_t IBit_State = StartCriticalSection();
+    ctcb_t **link = &CoopTasks;
+    while(*link != task)
+    {
+        link = &((*link)->nextTask);
+    }
+    *link = task->nextTask;
+    task->isAlive = false;
+    NumberOfCoopTasks--;
+    EndCriticalSection(IBit_State);
+
+    G8RTOS_PoolFree(&CoopTaskPool, task);
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds a stackless task to the cooperative host
+ *  - Takes a control block from the pool and clears its state
+ *  - Wakes the host if it is idle
+ * Param "taskToAdd": Handler that runs the task until its next yield point
+ * Returns: Error code for adding tasks
+ */
+sched_ErrCode_t G8RTOS_AddCoopTask(int32_t (*taskToAdd)(ctcb_t *task))
+{
+    int32_t IBit_State = StartCriticalSection();
+    if(CoopTaskPool.storage == 0)                       //First task sets up the pool
+    {
+        G8RTOS_InitPool(&CoopTaskPool, coopControlBlocks, sizeof(ctcb_t), MAX_COOP_TASKS);
+    }
+    EndCriticalSection(IBit_State);
+
+    ctcb_t *task = G8RTOS_PoolAlloc(&CoopTaskPool);
+    if(task == 0)
+    {
+        return COOP_TASK_LIMIT_REACHED;
+    }
+
+    for(uint8_t i = 0;i < COOP_STATE_WORDS;i++)
+    {
+        task->state[i] = 0;
+    }
+    task->handler = taskToAdd;
+    task->lineContinuation = 0;
+    task->wakeTime = SystemTime;                        //Due on the host's next pass
+    task->isAlive = true;
+
+    IBit_State = StartCriticalSection();
+    task->nextTask = CoopTasks;
+    CoopTasks = task;
+    NumberOfCoopTasks++;
+
+    bool wakeHost = CoopHostIdle;
+    CoopHostIdle = false;
+    EndCriticalSection(IBit_State);
+
+    if(wakeHost)
+    {
+        G8RTOS_SignalSemaphore(&CoopTaskAdded);
+    }
+    return NO_ERROR;
+}
+
+/*
+ * Cooperative host thread
+ *  - Runs every task whose wake time has passed, frees the ones that exit
+ *  - Sleeps until the earliest wake time, at least one tick so lower priority threads still run
+ *  - Blocks on CoopTaskAdded while there are no tasks
+ */
+void G8RTOS_CoopHost(void)
+{
+    G8RTOS_InitSemaphore(&CoopTaskAdded, 0);
+
+    while(1)
+    {
+        bool anyAlive = false;
+        uint32_t nextWake = 0;
+
+        ctcb_t *task = CoopTasks;
+        while(task != 0)
+        {
+            ctcb_t *next = task->nextTask;                      //Read first, an exited task goes back to the pool
+
+            if(G8RTOS_TIME_AFTER_EQ(SystemTime, task->wakeTime))   //Due, run it to its next yield point
+            {
+                if(task->handler(task) == COOP_EXITED)
+                {
+                    RemoveCoopTask(task);
+                    task = next;
+                    continue;
+                }
+            }
+
+            if(anyAlive == false || G8RTOS_TIME_BEFORE(task->wakeTime, nextWake))
+            {
+                nextWake = task->wakeTime;                      //Tracks the earliest wake time
+            }
+            anyAlive = true;
+            task = next;
+        }
+
+        if(anyAlive)
+        {
+            int32_t remaining = (int32_t)(nextWake - SystemTime);
+            sleep(remaining > 0 ? remaining : 1);
+        }
+        else
+        {
+            int32_t IBit_State = StartCriticalSection();
+            bool idle = (NumberOfCoopTasks == 0);               //Re-checked, a task may have been added during the pass
+            CoopHostIdle = idle;
+            EndCriticalSection(IBit_State);
+
+            if(idle)
+            {
+                G8RTOS_WaitSemaphore(&CoopTaskAdded);
+            }
+        }
+    }
+}
+
+/*
+ * Returns the number of cooperative tasks currently alive
+ */
+uint32_t G8RTOS_GetNumberOfCoopTasks(void)
+{
+    return NumberOfCoopTasks;
+}
+
+/*
+ * Copies the usage stats of the control block pool
+ */
+void G8RTOS_GetCoopPoolStats(pool_t *stats)
+{
+    G8RTOS_GetPoolStats(&CoopTaskPool, stats);
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,91 @@
+/**
+ * G8RTOS_Cooperative.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_COOPERATIVE_H_
+#define G8RTOS_COOPERATIVE_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define MAX_COOP_TASKS 32
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Task Status Codes ********************************************************************/
+#define COOP_YIELDED    0
+#define COOP_EXITED     1
+/*********************************************** Task Status Codes ********************************************************************/
+
+
+/*********************************************** Task Macros **************************************************************************/
+
+/*
+ * Cooperative tasks are protothread style state machines:
+ *  - Locals do not survive a yield, keep anything persistent in COOP_STATE
+ *  - Every yield point records the line it resumes from
+ *  - Do not place yield points inside a switch statement of your own
+ */
+
+/* Gives the task's private state words as a pointer to "type" */
+#define COOP_STATE(task, type)      ((type *)((task)->state))
+
+/* Opens the body of a task, resumes at the last yield point */
+#define COOP_BEGIN(task)            switch((task)->lineContinuation) { case 0:
+
+/* Gives up the host thread, the task runs again on the host's next pass */
+#define COOP_YIELD(task)            do { (task)->wakeTime = SystemTime; (task)->lineContinuation = __LINE__; \
+                                         return COOP_YIELDED; case __LINE__:; } while(0)
+
+/* Gives up the host thread for at least "ms" system ticks */
+#define COOP_SLEEP(task, ms)        do { (task)->wakeTime = SystemTime + (ms); (task)->lineContinuation = __LINE__; \
+                                         return COOP_YIELDED; case __LINE__:; } while(0)
+
+/* Yields until "cond" is true, checked once per host pass */
+#define COOP_WAIT_UNTIL(task, cond) do { (task)->wakeTime = SystemTime; (task)->lineContinuation = __LINE__; \
+                                         case __LINE__: if(!(cond)) return COOP_YIELDED; } while(0)
+
+/* Ends the task from anywhere in its body */
+#define COOP_EXIT(task)             do { (task)->lineContinuation = 0; return COOP_EXITED; } while(0)
+
+/* Closes the body of a task */
+#define COOP_END(task)              } (task)->lineContinuation = 0; return COOP_EXITED
+
+/*********************************************** Task Macros **************************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds a stackless task to the cooperative host
+ *  - Task state words are zeroed, the handler starts at COOP_BEGIN on the host's next pass
+ * Param "taskToAdd": Handler that runs the task until its next yield point, returns COOP_YIELDED or COOP_EXITED
+ * Returns: Error code for adding tasks
+ */
+sched_ErrCode_t G8RTOS_AddCoopTask(int32_t (*taskToAdd)(ctcb_t *task));
+
+/*
+ * Cooperative host thread
+ *  - Add it once with G8RTOS_AddThread, all cooperative tasks share its stack and priority
+ *  - Runs every task that is due, then sleeps until the earliest wake time
+ *  - Blocks while no tasks exist
+ */
+void G8RTOS_CoopHost(void);
+
+/*
+ * Returns the number of cooperative tasks currently alive
+ */
+uint32_t G8RTOS_GetNumberOfCoopTasks(void);
+
+/*
+ * Copies the usage stats of the control block pool, peakInUse shows how close MAX_COOP_TASKS is
+ * Param "stats": Copy of the pool
+ */
+void G8RTOS_GetCoopPoolStats(pool_t *stats);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_COOPERATIVE_H_ */
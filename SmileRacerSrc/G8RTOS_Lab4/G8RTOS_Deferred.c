@@ -0,0 +1,215 @@
+/**
+ * G8RTOS_Deferred.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_nvic.h"
+#include "driverlib/interrupt.h"
+#include "G8RTOS_Deferred.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Timebase.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Deferred Event Control Blocks
+ *  - One per IRQ handed to the dispatcher
+ */
+static dpcb_t deferredEvents[MAX_DEFERRED_EVENTS];
+
+/* Vector Lookup
+ *  - Maps an active vector number to its event index + 1, 0 when the vector has no deferred event
+ */
+static uint8_t vectorToEvent[NUM_INTERRUPTS];
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Current Number of deferred events
+ */
+static uint32_t NumberOfDeferredEvents;
+
+/*
+ * Work queue of pending bottom halves, oldest first
+ */
+static dpcb_t *WorkHead;
+static dpcb_t *WorkTail;
+
+/*
+ * Counts bottom halves waiting in the work queue
+ */
+static semaphore_t WorkAvailable;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Kernel dispatcher installed in the vector table for every deferred event
+ *  - Looks the event up by the active vector
+ *  - Runs the top half and records how long it took
+ *  - Queues the bottom half, a post while it is still pending is only counted
+ */
+static void G8RTOS_DeferredDispatcher(void)
+{
+    uint32_t start = G8RTOS_GetCycleCount();
+    uint32_t vector = HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M;
+    dpcb_t *event = &deferredEvents[vectorToEvent[vector] - 1];
+
+    event->topHalf();
+
+    int32_t IBit_State = StartCriticalSection();
+    uint32_t now = G8RTOS_GetCycleCount();
+    if(now - start > event->maxTopHalfCycles)
+    {
+        event->maxTopHalfCycles = now - start;
+    }
+
+    bool post = (event->pending == false);
+    if(post)
+    {
+        event->pending = true;
+        event->postTime = now;
+        event->nextPending = 0;
+        if(WorkTail == 0)
+        {
+            WorkHead = event;
+        }
+        else
+        {
+            WorkTail->nextPending = event;
+        }
+        WorkTail = event;
+    }
+    else
+    {
+        event->coalesced++;
+    }
+    EndCriticalSection(IBit_State);
+
+    if(post)
+    {
+        G8RTOS_SignalSemaphore(&WorkAvailable);
+    }
+}
+
+/*
+ * Deferred worker thread
+ *  - Pops the oldest pending event and runs its bottom half
+ *  - The event is re-armed before the bottom half runs so interrupts during it are not lost
+ */
+static void G8RTOS_DeferredWorker(void)
+{
+    while(1)
+    {
+        G8RTOS_WaitSemaphore(&WorkAvailable);
+
+        int32_t IBit_State = StartCriticalSection();
+        dpcb_t *event = WorkHead;
+        WorkHead = event->nextPending;
+        if(WorkHead == 0)
+        {
+            WorkTail = 0;
+        }
+        event->pending = false;
+
+        uint32_t latency = G8RTOS_GetCycleCount() - event->postTime;
+        event->count++;
+        event->totalLatencyCycles += latency;
+        if(latency > event->maxLatencyCycles)
+        {
+            event->maxLatencyCycles = latency;
+        }
+        EndCriticalSection(IBit_State);
+
+        event->bottomHalf();
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds a deferred event to G8RTOS
+ *  - Checks the IRQ and priority the same way aperiodic events do
+ *  - Adds the worker thread with the first event
+ *  - Points the IRQ's vector at the dispatcher and enables it
+ * Returns: Error code for adding deferred events
+ */
+sched_ErrCode_t G8RTOS_AddDeferredEvent(void (*topHalf)(void), void (*bottomHalf)(void), uint8_t priority, int32_t IRQn)
+{
+    if(IRQn < 0 || IRQn >= NUM_INTERRUPTS)          //Checks to see if IRQ is in range
+    {
+        return IRQn_INVALID;
+    }
+    if(priority > 6)                                //Checks if priority too low
+    {
+        return HWI_PRIORITY_INVALID;
+    }
+    if(NumberOfDeferredEvents >= MAX_DEFERRED_EVENTS)
+    {
+        return DEFERRED_LIMIT_REACHED;
+    }
+
+    if(NumberOfDeferredEvents == 0)                 //First event brings up the worker
+    {
+        G8RTOS_InitSemaphore(&WorkAvailable, 0);
+        sched_ErrCode_t err = G8RTOS_AddThread(G8RTOS_DeferredWorker, DEFERRED_WORKER_PRIORITY, "deferred");
+        if(err != NO_ERROR)
+        {
+            return err;
+        }
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+    dpcb_t *event = &deferredEvents[NumberOfDeferredEvents];
+    event->topHalf = topHalf;
+    event->bottomHalf = bottomHalf;
+    event->IRQn = IRQn;
+    event->pending = false;
+    NumberOfDeferredEvents++;
+    vectorToEvent[IRQn] = NumberOfDeferredEvents;
+
+    uint32_t *vectors = (uint32_t *)HWREG(NVIC_VTABLE);
+    vectors[IRQn] = (uint32_t)G8RTOS_DeferredDispatcher;
+
+    IntPrioritySet(IRQn, priority << 5);            //NVIC priority lives in the top 3 bits
+    IntEnable(IRQn);
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Copies the latency stats of a deferred event
+ * Returns: Error code if the IRQ has no deferred event
+ */
+sched_ErrCode_t G8RTOS_GetDeferredStats(int32_t IRQn, dpcb_t *stats)
+{
+    if(IRQn < 0 || IRQn >= NUM_INTERRUPTS || vectorToEvent[IRQn] == 0)
+    {
+        return IRQn_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+    *stats = deferredEvents[vectorToEvent[IRQn] - 1];
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*********************************************** Public Functions *********************************************************************/
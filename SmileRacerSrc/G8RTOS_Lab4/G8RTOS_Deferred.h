@@ -0,0 +1,44 @@
+/**
+ * G8RTOS_Deferred.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_DEFERRED_H_
+#define G8RTOS_DEFERRED_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define MAX_DEFERRED_EVENTS 8
+#define DEFERRED_WORKER_PRIORITY 0
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds a deferred event to G8RTOS
+ *  - Points the IRQ's vector at the kernel dispatcher
+ *  - The dispatcher runs the top half at interrupt level, then queues the bottom half
+ *  - The deferred worker thread is added on first use and runs bottom halves in order
+ * Param "topHalf": Acknowledges the interrupt and grabs volatile data, keep it to a few microseconds
+ * Param "bottomHalf": Remaining work, runs at thread level and may use any kernel call but sleep
+ * Param "priority": NVIC priority 0-6 of the IRQ
+ * Param "IRQn": Vector number of the IRQ (e.g. INT_UART1)
+ * Returns: Error code for adding deferred events
+ */
+sched_ErrCode_t G8RTOS_AddDeferredEvent(void (*topHalf)(void), void (*bottomHalf)(void), uint8_t priority, int32_t IRQn);
+
+/*
+ * Copies the latency stats of a deferred event
+ * Param "IRQn": Vector number the event was added with
+ * Param "stats": Copy of the event control block
+ * Returns: Error code if the IRQ has no deferred event
+ */
+sched_ErrCode_t G8RTOS_GetDeferredStats(int32_t IRQn, dpcb_t *stats);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_DEFERRED_H_ */
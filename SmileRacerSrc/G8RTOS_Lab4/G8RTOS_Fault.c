@@ -0,0 +1,75 @@
+/**
+ * G8RTOS_Fault.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "G8RTOS_Fault.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Last stack fault
+ */
+static fault_t FaultRecord;
+
+/*
+ * Reports the fault, set by the application
+ */
+static void (*FaultHook)(fault_t *fault);
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Sets the function run when a thread overflows its stack
+ */
+void G8RTOS_SetFaultHook(void (*hook)(fault_t *fault))
+{
+    FaultHook = hook;
+}
+
+/*
+ * Returns the record of the last stack fault
+ */
+fault_t *G8RTOS_GetFaultRecord(void)
+{
+    return &FaultRecord;
+}
+
+/*
+ * Records a stack fault and halts
+ *  - The guard only covers the running thread's stack, so the running thread is the one that overflowed
+ *  - The address is only valid for data access faults, stacking faults leave it 0
+ */
+void G8RTOS_StackFault(void)
+{
+    uint32_t status = HWREG(NVIC_FAULT_STAT);
+
+    FaultRecord.ThreadID = CurrentlyRunningThread->ThreadID;
+    for(uint8_t i = 0;i < MAX_NAME_LENGTH;i++)
+    {
+        FaultRecord.Threadname[i] = CurrentlyRunningThread->Threadname[i];
+    }
+    FaultRecord.Threadname[MAX_NAME_LENGTH] = 0;
+    FaultRecord.faultStatus = status;
+    FaultRecord.faultAddress = (status & NVIC_FAULT_STAT_MMARV) ? HWREG(NVIC_MM_ADDR) : 0;
+
+    if(FaultHook != 0)
+    {
+        FaultHook(&FaultRecord);
+    }
+    while(1);
+}
+
+/*********************************************** Public Functions *********************************************************************/
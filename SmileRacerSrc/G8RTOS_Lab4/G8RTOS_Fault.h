@@ -0,0 +1,41 @@
+/**
+ * G8RTOS_Fault.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_FAULT_H_
+#define G8RTOS_FAULT_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define STACK_GUARD_REGION 0
+#define STACK_GUARD_BYTES 32
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Sets the function run when a thread overflows its stack
+ *  - Runs in the MemManage handler on a private fault stack, interrupts are masked by priority
+ *  - Must not use kernel calls, the system halts once it returns
+ * Param "hook": Function given the fault record, 0 to only halt
+ */
+void G8RTOS_SetFaultHook(void (*hook)(fault_t *fault));
+
+/*
+ * Returns the record of the last stack fault, ThreadID is 0 if there was none
+ */
+fault_t *G8RTOS_GetFaultRecord(void);
+
+/*
+ * Records a stack fault and halts, kernel use only
+ *  - Called by MemManage_Handler after it moves to the fault stack
+ */
+void G8RTOS_StackFault(void);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_FAULT_H_ */
@@ -0,0 +1,39 @@
+; G8RTOS_FaultASM.s - uP2 Fall 2022
+; Holds the MemManage handler that catches stack overflows
+; Note: If you have an h file, do not have a C file and an S file of the same name
+
+	; Functions Defined
+	.def MemManage_Handler
+
+	; Dependencies
+	.ref G8RTOS_StackFault
+
+	; Private stack for the fault handler, the faulting thread's stack is what overflowed
+FaultStack: .usect ".bss", 512, 8
+
+	.thumb		; Set to thumb mode
+	.align 2	; Align by 2 bytes (thumb mode uses allignment by 2 or 4)
+	.text		; Text section
+
+FaultStackTop: .field FaultStack + 512, 32
+
+; MemManage_Handler
+; - Runs when a thread touches the no-access guard at the bottom of its stack
+;	- Moves onto the fault stack so the report does not fault again
+;	- Calls G8RTOS_StackFault, which never returns
+MemManage_Handler:
+
+	.asmfunc
+
+	LDR R0, FaultStackTop	;Loads the top of the fault stack
+	MOV SP, R0				;Switches to it
+
+	BL G8RTOS_StackFault	;Records and reports the fault
+
+	B MemManage_Handler		;Not reached
+
+	.endasmfunc
+
+	; end of the asm file
+	.align
+	.end
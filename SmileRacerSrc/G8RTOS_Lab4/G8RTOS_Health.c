@@ -0,0 +1,235 @@
+/**
+ * G8RTOS_Health.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/watchdog.h"
+#include "G8RTOS_Health.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Sections.h"
+#include "G8RTOS_Timebase.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Marks the reset record as written by the monitor rather than power-on garbage */
+#define RESET_RECORD_VALID  0x4845414C
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Health Control Blocks
+ *  - One per registered thread, thread is 0 when the entry is free
+ */
+static hcb_t healthChecks[MAX_HEALTH_CHECKS];
+
+/* Reset Record
+ *  - Survives the watchdog reset
+ */
+NOINIT static resetRecord_t ResetRecord;
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Set once a thread has missed its check-in, the watchdog is no longer fed
+ */
+static bool ThreadMissed;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Health monitor periodic event
+ *  - Drops entries of threads that were killed
+ *  - Feeds the watchdog only if every registered thread checked in on time
+ *  - The first thread found late is written to the reset record and the watchdog is left to expire
+ */
+static void G8RTOS_HealthMonitor(void)
+{
+    if(ThreadMissed)
+    {
+        return;
+    }
+
+    for(uint8_t i = 0;i < MAX_HEALTH_CHECKS;i++)
+    {
+        hcb_t *check = &healthChecks[i];
+        if(check->thread == 0)
+            continue;
+
+        if(check->thread->isAlive == false || check->thread->ThreadID != check->ThreadID)
+        {
+            check->thread = 0;                          //Thread was killed, block may hold a new thread
+            continue;
+        }
+
+        uint32_t sinceCheckIn = SystemTime - check->lastCheckIn;
+        if(sinceCheckIn > check->period)
+        {
+            ResetRecord.ThreadID = check->ThreadID;
+            for(uint8_t j = 0;j < MAX_NAME_LENGTH;j++)
+            {
+                ResetRecord.Threadname[j] = check->thread->Threadname[j];
+            }
+            ResetRecord.Threadname[MAX_NAME_LENGTH] = 0;
+            ResetRecord.missedAt = SystemTime;
+            ResetRecord.lateBy = sinceCheckIn - check->period;
+            ResetRecord.valid = RESET_RECORD_VALID;
+            ThreadMissed = true;
+            return;
+        }
+    }
+
+    WatchdogIntClear(WATCHDOG0_BASE);                   //Everyone is healthy, feed the watchdog
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the health monitor and the watchdog
+ *  - The watchdog is only enabled once the monitor that feeds it is running
+ */
+sched_ErrCode_t G8RTOS_StartHealthMonitor(void)
+{
+    uint32_t cause = SysCtlResetCauseGet();
+    SysCtlResetCauseClear(cause);
+    if(cause & SYSCTL_CAUSE_POR)                        //Record is garbage after power-on
+    {
+        ResetRecord.valid = 0;
+        ResetRecord.watchdogResets = 0;
+    }
+    if(cause & SYSCTL_CAUSE_WDOG0)
+    {
+        ResetRecord.watchdogResets++;
+    }
+
+    sched_ErrCode_t error = G8RTOS_AddPeriodicEvent(G8RTOS_HealthMonitor, HEALTH_CHECK_PERIOD,
+                                                    SystemTime + HEALTH_CHECK_PERIOD, HEALTH_MONITOR_BUDGET_US);
+    if(error != NO_ERROR)                               //Nobody would feed it, leave the watchdog off
+    {
+        return error;
+    }
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_WDOG0);
+    WatchdogReloadSet(WATCHDOG0_BASE, SysCtlClockGet() / 1000 * WATCHDOG_TIMEOUT_MS);
+    WatchdogResetEnable(WATCHDOG0_BASE);
+    WatchdogStallEnable(WATCHDOG0_BASE);                //Stops with the CPU at a breakpoint
+    WatchdogEnable(WATCHDOG0_BASE);
+    return NO_ERROR;
+}
+
+/*
+ * Prints how long the monitor runs against its budget
+ */
+void G8RTOS_DumpHealthStats(void (*print)(const char *format, ...))
+{
+    ptcb_t stats;
+    if(G8RTOS_GetPeriodicStats(G8RTOS_HealthMonitor, &stats) != NO_ERROR)
+    {
+        print("health monitor not running\n");
+        return;
+    }
+    print("health monitor max %u us, budget %u us, %u overruns%s\n",
+          stats.maxCycles / G8RTOS_GetCyclesPerUs(), stats.budgetUs, stats.overruns,
+          (stats.overruns != 0) ? " OVER BUDGET" : "");
+}
+
+/*
+ * Registers the calling thread with the health monitor
+ *  - Reuses the calling thread's entry if it already has one
+ * Returns: Error code for registering
+ */
+sched_ErrCode_t G8RTOS_RegisterHealthCheck(uint32_t periodMS)
+{
+    int32_t IBit_State = StartCriticalSection();
+    hcb_t *check = 0;
+    for(uint8_t i = 0;i < MAX_HEALTH_CHECKS;i++)
+    {
+        if(healthChecks[i].thread == CurrentlyRunningThread && healthChecks[i].ThreadID == CurrentlyRunningThread->ThreadID)
+        {
+            check = &healthChecks[i];
+            break;
+        }
+        if(check == 0 && healthChecks[i].thread == 0)
+        {
+            check = &healthChecks[i];
+        }
+    }
+    if(check == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return HEALTH_LIMIT_REACHED;
+    }
+
+    check->thread = CurrentlyRunningThread;
+    check->ThreadID = CurrentlyRunningThread->ThreadID;
+    check->period = periodMS;
+    check->lastCheckIn = SystemTime;
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Checks in the calling thread
+ *  - Matches the ID too, a reused thread block must not refresh the old thread's stale entry
+ */
+void G8RTOS_CheckIn(void)
+{
+    for(uint8_t i = 0;i < MAX_HEALTH_CHECKS;i++)
+    {
+        if(healthChecks[i].thread == CurrentlyRunningThread && healthChecks[i].ThreadID == CurrentlyRunningThread->ThreadID)
+        {
+            healthChecks[i].lastCheckIn = SystemTime;   //Single word store, no critical section needed
+            return;
+        }
+    }
+}
+
+/*
+ * Returns the record of the thread that caused the last watchdog reset
+ */
+resetRecord_t *G8RTOS_GetResetRecord(void)
+{
+    return (ResetRecord.valid == RESET_RECORD_VALID) ? &ResetRecord : 0;
+}
+
+/*
+ * Forgets the last watchdog reset
+ */
+void G8RTOS_ClearResetRecord(void)
+{
+    ResetRecord.valid = 0;
+}
+
+/*
+ * Reloads the watchdog for the new clock so the timeout stays WATCHDOG_TIMEOUT_MS
+ *  - Writing the load also restarts the count, a clock change counts as one feed
+ */
+void G8RTOS_HealthClockChanged(uint32_t clockHz)
+{
+    if(SysCtlPeripheralReady(SYSCTL_PERIPH_WDOG0) && WatchdogRunning(WATCHDOG0_BASE))
+    {
+        WatchdogReloadSet(WATCHDOG0_BASE, clockHz / 1000 * WATCHDOG_TIMEOUT_MS);
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
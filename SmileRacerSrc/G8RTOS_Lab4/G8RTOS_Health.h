@@ -0,0 +1,71 @@
+/**
+ * G8RTOS_Health.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_HEALTH_H_
+#define G8RTOS_HEALTH_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define MAX_HEALTH_CHECKS 8
+#define HEALTH_CHECK_PERIOD 100
+#define WATCHDOG_TIMEOUT_MS 500
+#define HEALTH_MONITOR_BUDGET_US 20
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the health monitor and the watchdog
+ *  - Validates the reset record, clears it after a power-on
+ *  - Adds the monitor as a periodic event every HEALTH_CHECK_PERIOD ms
+ *  - The watchdog resets the board WATCHDOG_TIMEOUT_MS to twice that after the last feed
+ * Call after InitializeBoard, the watchdog is loaded from the system clock
+ * Returns: Error code for adding the monitor, the watchdog stays off if it fails
+ */
+sched_ErrCode_t G8RTOS_StartHealthMonitor(void);
+
+/*
+ * Prints the monitor's longest run, its budget and how many runs went over it
+ * Param "print": printf-style output function, e.g. UARTprintf
+ */
+void G8RTOS_DumpHealthStats(void (*print)(const char *format, ...));
+
+/*
+ * Registers the calling thread with the health monitor
+ *  - Counts as its first check-in
+ *  - Entries of threads that were killed are dropped by the monitor
+ * Param "periodMS": Longest the thread may go between check-ins
+ * Returns: Error code for registering
+ */
+sched_ErrCode_t G8RTOS_RegisterHealthCheck(uint32_t periodMS);
+
+/*
+ * Checks in the calling thread, does nothing if it is not registered
+ */
+void G8RTOS_CheckIn(void);
+
+/*
+ * Returns the record of the thread that caused the last watchdog reset, 0 if there is none
+ */
+resetRecord_t *G8RTOS_GetResetRecord(void);
+
+/*
+ * Forgets the last watchdog reset, the reset count is kept
+ */
+void G8RTOS_ClearResetRecord(void);
+
+/*
+ * Reloads the watchdog after a clock change, kernel use only
+ * Param "clockHz": New CPU clock in Hz
+ */
+void G8RTOS_HealthClockChanged(uint32_t clockHz);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_HEALTH_H_ */
@@ -0,0 +1,139 @@
+/**
+ * G8RTOS_Pool.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "G8RTOS_Pool.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Index of a block inside its pool's storage
+ */
+static uint32_t BlockIndex(pool_t *pool, void *block)
+{
+    return ((uint8_t *)block - pool->storage) / pool->blockSize;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Initializes a fixed-block pool over static storage
+ *  - Links every block into the free list, first block first
+ *  - Clears the in-use bitmap that follows the blocks
+ * Returns: Error code if the storage or sizes are invalid
+ */
+sched_ErrCode_t G8RTOS_InitPool(pool_t *pool, void *storage, uint32_t blockSize, uint32_t numBlocks)
+{
+    if(storage == 0 || blockSize == 0 || numBlocks == 0)
+    {
+        return POOL_INVALID;
+    }
+
+    int32_t IBit_State = StartCriticalSection();
+    pool->storage = (uint8_t *)storage;
+    pool->blockSize = POOL_BLOCK_WORDS(blockSize) * 4;
+    pool->numBlocks = numBlocks;
+    pool->inUseMap = (uint32_t *)(pool->storage + numBlocks * pool->blockSize);
+    for(uint32_t i = 0;i < POOL_MAP_WORDS(numBlocks);i++)
+    {
+        pool->inUseMap[i] = 0;
+    }
+    pool->inUse = 0;
+    pool->peakInUse = 0;
+    pool->allocations = 0;
+    pool->failedAllocations = 0;
+
+    pool->freeList = 0;
+    for(uint32_t i = numBlocks;i > 0;i--)           //Pushed last to first so the list starts at block 0
+    {
+        void **block = (void **)(pool->storage + (i - 1) * pool->blockSize);
+        *block = pool->freeList;
+        pool->freeList = block;
+    }
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Takes a block from a pool in constant time
+ *  - Pops the head of the free list
+ * Returns: Pointer to the block, 0 if the pool is empty
+ */
+void *G8RTOS_PoolAlloc(pool_t *pool)
+{
+    int32_t IBit_State = StartCriticalSection();
+    void **block = (void **)pool->freeList;
+    if(block == 0)
+    {
+        pool->failedAllocations++;
+        EndCriticalSection(IBit_State);
+        return 0;
+    }
+
+    pool->freeList = *block;
+    uint32_t index = BlockIndex(pool, block);
+    pool->inUseMap[index / 32] |= (1u << (index % 32));
+    pool->inUse++;
+    pool->allocations++;
+    if(pool->inUse > pool->peakInUse)
+    {
+        pool->peakInUse = pool->inUse;
+    }
+    EndCriticalSection(IBit_State);
+    return block;
+}
+
+/*
+ * Gives a block back to its pool in constant time
+ *  - Rejects pointers outside the storage or not on a block boundary
+ *  - Rejects a block whose in-use bit is clear, a second free would loop the free list
+ *  - Pushes the block on the head of the free list
+ * Returns: Error code if the block does not belong to the pool or was already freed
+ */
+sched_ErrCode_t G8RTOS_PoolFree(pool_t *pool, void *block)
+{
+    uint32_t offset = (uint8_t *)block - pool->storage;
+    if((uint8_t *)block < pool->storage || offset >= pool->numBlocks * pool->blockSize || offset % pool->blockSize != 0)
+    {
+        return POOL_INVALID;
+    }
+
+    uint32_t index = offset / pool->blockSize;
+    uint32_t bit = (1u << (index % 32));
+
+    int32_t IBit_State = StartCriticalSection();
+    if((pool->inUseMap[index / 32] & bit) == 0)
+    {
+        EndCriticalSection(IBit_State);
+        return POOL_DOUBLE_FREE;
+    }
+    pool->inUseMap[index / 32] &= ~bit;
+    *(void **)block = pool->freeList;
+    pool->freeList = block;
+    pool->inUse--;
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Copies the usage stats of a pool
+ */
+void G8RTOS_GetPoolStats(pool_t *pool, pool_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+    *stats = *pool;
+    EndCriticalSection(IBit_State);
+}
+
+/*********************************************** Public Functions *********************************************************************/
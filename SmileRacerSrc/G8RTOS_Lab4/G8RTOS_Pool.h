@@ -0,0 +1,69 @@
+/**
+ * G8RTOS_Pool.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_POOL_H_
+#define G8RTOS_POOL_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Words one block of "blockSize" bytes takes, blocks stay word aligned */
+#define POOL_BLOCK_WORDS(blockSize)     (((blockSize) + 3) / 4)
+
+/* Words of the in-use bitmap kept after the blocks, one bit per block */
+#define POOL_MAP_WORDS(numBlocks)       (((numBlocks) + 31) / 32)
+
+/* Declares storage for a pool of "numBlocks" blocks of "blockSize" bytes and its in-use bitmap */
+#define G8RTOS_POOL_STORAGE(name, blockSize, numBlocks) \
+    static uint32_t name[POOL_BLOCK_WORDS(blockSize) * (numBlocks) + POOL_MAP_WORDS(numBlocks)]
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Initializes a fixed-block pool over static storage
+ *  - Every block starts out free, stats are cleared
+ * Param "pool": Pool to initialize
+ * Param "storage": Storage declared with G8RTOS_POOL_STORAGE
+ * Param "blockSize": Size of one block in bytes, rounded up to a whole word
+ * Param "numBlocks": Number of blocks in the storage
+ * Returns: Error code if the storage or sizes are invalid
+ */
+sched_ErrCode_t G8RTOS_InitPool(pool_t *pool, void *storage, uint32_t blockSize, uint32_t numBlocks);
+
+/*
+ * Takes a block from a pool in constant time
+ *  - Safe from threads and ISRs, never blocks
+ *  - Contents of the block are not cleared
+ * Param "pool": Pool to allocate from
+ * Returns: Pointer to the block, 0 if the pool is empty
+ */
+void *G8RTOS_PoolAlloc(pool_t *pool);
+
+/*
+ * Gives a block back to its pool in constant time
+ *  - Safe from threads and ISRs
+ *  - A block that is already free is rejected, the free list and stats are left alone
+ * Param "pool": Pool the block came from
+ * Param "block": Block to free
+ * Returns: Error code if the block does not belong to the pool or was already freed
+ */
+sched_ErrCode_t G8RTOS_PoolFree(pool_t *pool, void *block);
+
+/*
+ * Copies the usage stats of a pool
+ * Param "pool": Pool to read
+ * Param "stats": Copy of the pool, its free list is only a snapshot
+ */
+void G8RTOS_GetPoolStats(pool_t *pool, pool_t *stats);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_POOL_H_ */
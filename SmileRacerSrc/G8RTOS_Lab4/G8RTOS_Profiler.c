@@ -0,0 +1,345 @@
+/**
+ * G8RTOS_Profiler.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+#include "G8RTOS_Profiler.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_Sections.h"
+#include "G8RTOS_Health.h"
+
+/*
+ * Profiler_Handler exists in asm
+ */
+extern void Profiler_Handler(void);
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Periodic timer that drives the sampler, the wake timer has Timer 2 and the game has Timers 0 and 1 */
+#define PROFILER_TIMER_BASE     TIMER3_BASE
+#define PROFILER_TIMER_PERIPH   SYSCTL_PERIPH_TIMER3
+#define PROFILER_TIMER_INT      INT_TIMER3A
+
+/* EXC_RETURN bit 3 is set when the sampler interrupted thread mode */
+#define EXC_RETURN_THREAD       0x00000008
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Sample Buffer
+ *  - Filled in order by the sampler until full
+ */
+static pcSample_t profileSamples[PROFILER_SAMPLES];
+
+/* Thread Names
+ *  - Every thread seen during the capture, copied when first sampled so threads killed before the dump keep their name
+ */
+static threadId_t profileThreadIDs[PROFILER_MAX_THREADS];
+static char profileThreadNames[PROFILER_MAX_THREADS][MAX_NAME_LENGTH + 1];
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Samples taken so far and the ticks that came after the buffer filled
+ */
+static uint32_t NumberOfSamples;
+static uint32_t MissedSamples;
+
+/*
+ * Threads in the name table, and the last one looked up so back to back samples skip the search
+ */
+static uint32_t NumberOfProfileThreads;
+static threadId_t LastProfileThread;
+
+/*
+ * Rate of the current capture
+ */
+static uint32_t ProfileRateHz;
+
+/*
+ * Profile sites that have finished at least once, oldest first
+ */
+static profileSite_t *ProfileSites;
+static profileSite_t *LastProfileSite;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Copies the running thread's name into the table the first time it is sampled
+ *  - Threads past PROFILER_MAX_THREADS are still sampled, the host shows their ID
+ */
+static void RememberThread(tcb_t *thread)
+{
+    if(thread->ThreadID == LastProfileThread)
+    {
+        return;
+    }
+    LastProfileThread = thread->ThreadID;
+
+    for(uint32_t i = 0;i < NumberOfProfileThreads;i++)
+    {
+        if(profileThreadIDs[i] == thread->ThreadID)
+        {
+            return;
+        }
+    }
+    if(NumberOfProfileThreads >= PROFILER_MAX_THREADS)
+    {
+        return;
+    }
+
+    char *name = profileThreadNames[NumberOfProfileThreads];
+    uint8_t c = 0;
+    while(c < MAX_NAME_LENGTH && thread->Threadname[c] != 0)
+    {
+        name[c] = thread->Threadname[c];
+        c++;
+    }
+    name[c] = 0;
+    profileThreadIDs[NumberOfProfileThreads] = thread->ThreadID;
+    NumberOfProfileThreads++;
+}
+
+/*
+ * Returns the histogram bucket of a run, floor(log2(cycles)) capped at the last bucket
+ *  - Halving search, a fixed five compares whatever the length
+ */
+static uint32_t HistogramBucket(uint32_t cycles)
+{
+    uint32_t bucket = 0;
+    if(cycles >= (1u << 16)) { cycles >>= 16; bucket += 16; }
+    if(cycles >= (1u << 8))  { cycles >>= 8;  bucket += 8; }
+    if(cycles >= (1u << 4))  { cycles >>= 4;  bucket += 4; }
+    if(cycles >= (1u << 2))  { cycles >>= 2;  bucket += 2; }
+    if(cycles >= (1u << 1))  { bucket += 1; }
+    return (bucket < PROFILE_HISTOGRAM_BUCKETS) ? bucket : PROFILE_HISTOGRAM_BUCKETS - 1;
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Adds one run to a profile site
+ *  - Links the site into the list on its first run
+ *  - Safe from threads and interrupts, the update is one critical section
+ */
+void G8RTOS_ScopeExit(profileSite_t *site, uint32_t start)
+{
+    uint32_t cycles = DWT_CYCCNT_R - start;
+
+    int32_t IBit_State = StartCriticalSection();
+    if(site->registered == false)
+    {
+        site->registered = true;
+        site->nextSite = 0;
+        if(LastProfileSite == 0)
+        {
+            ProfileSites = site;
+        }
+        else
+        {
+            LastProfileSite->nextSite = site;
+        }
+        LastProfileSite = site;
+    }
+
+    if(site->count == 0 || cycles < site->minCycles)
+    {
+        site->minCycles = cycles;
+    }
+    if(cycles > site->maxCycles)
+    {
+        site->maxCycles = cycles;
+    }
+    site->count++;
+    site->sumCycles += cycles;
+    site->histogram[HistogramBucket(cycles)]++;
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Prints every profile site that has run
+ *  - Copies each site before printing so the line is consistent
+ */
+void G8RTOS_DumpProfileScopes(void (*print)(const char *format, ...))
+{
+    print("site             count    min cyc    max cyc   mean cyc  mean us\n");
+    for(profileSite_t *site = ProfileSites;site != 0;site = site->nextSite)
+    {
+        int32_t IBit_State = StartCriticalSection();
+        profileSite_t copy = *site;
+        EndCriticalSection(IBit_State);
+
+        if(copy.count == 0)
+        {
+            continue;
+        }
+        uint32_t mean = (uint32_t)(copy.sumCycles / copy.count);
+        print("%16s %6u %10u %10u %10u %8u\n", copy.name, copy.count, copy.minCycles, copy.maxCycles,
+              mean, mean / G8RTOS_GetCyclesPerUs());
+
+        print("  log2 cycles:");
+        for(uint32_t i = 0;i < PROFILE_HISTOGRAM_BUCKETS;i++)
+        {
+            if(copy.histogram[i] != 0)
+            {
+                print(" %u:%u", i, copy.histogram[i]);
+            }
+        }
+        print("\n");
+        G8RTOS_CheckIn();                           //Two lines per site, keep the dumping thread's health check fed
+    }
+}
+
+/*
+ * Clears the accumulators of every profile site
+ */
+void G8RTOS_ResetProfileScopes(void)
+{
+    for(profileSite_t *site = ProfileSites;site != 0;site = site->nextSite)
+    {
+        int32_t IBit_State = StartCriticalSection();
+        site->count = 0;
+        site->minCycles = 0;
+        site->maxCycles = 0;
+        site->sumCycles = 0;
+        for(uint32_t i = 0;i < PROFILE_HISTOGRAM_BUCKETS;i++)
+        {
+            site->histogram[i] = 0;
+        }
+        EndCriticalSection(IBit_State);
+    }
+}
+
+/*
+ * Sampler interrupt, entered from Profiler_Handler
+ *  - Records the stacked PC and the running thread, or PROFILER_ISR_ID if a handler was interrupted
+ *  - Stops the timer once the buffer is full
+ */
+RAMFUNC void G8RTOS_ProfilerSample(uint32_t *frame, uint32_t excReturn)
+{
+    TimerIntClear(PROFILER_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+
+    if(NumberOfSamples >= PROFILER_SAMPLES)
+    {
+        MissedSamples++;
+        TimerDisable(PROFILER_TIMER_BASE, TIMER_A);
+        return;
+    }
+
+    pcSample_t *sample = &profileSamples[NumberOfSamples];
+    sample->pc = frame[6];
+    if(excReturn & EXC_RETURN_THREAD)
+    {
+        sample->ThreadID = CurrentlyRunningThread->ThreadID;
+        RememberThread(CurrentlyRunningThread);
+    }
+    else
+    {
+        sample->ThreadID = PROFILER_ISR_ID;
+    }
+    NumberOfSamples++;
+}
+
+/*
+ * Starts a capture of the PC sampler
+ *  - Clears the previous capture
+ *  - Runs the timer at priority 0 so other interrupts are sampled as well
+ */
+void G8RTOS_StartProfiler(uint32_t rateHz)
+{
+    G8RTOS_StopProfiler();
+
+    int32_t IBit_State = StartCriticalSection();
+    NumberOfSamples = 0;
+    MissedSamples = 0;
+    NumberOfProfileThreads = 0;
+    LastProfileThread = PROFILER_ISR_ID;
+    ProfileRateHz = rateHz;
+    EndCriticalSection(IBit_State);
+
+    SysCtlPeripheralEnable(PROFILER_TIMER_PERIPH);
+    TimerConfigure(PROFILER_TIMER_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(PROFILER_TIMER_BASE, TIMER_A, G8RTOS_GetCyclesPerUs() * 1000000 / rateHz);
+    TimerIntEnable(PROFILER_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    ((uint32_t *)HWREG(NVIC_VTABLE))[PROFILER_TIMER_INT] = (uint32_t)Profiler_Handler;
+    IntPrioritySet(PROFILER_TIMER_INT, 0x00);
+    IntEnable(PROFILER_TIMER_INT);
+    TimerEnable(PROFILER_TIMER_BASE, TIMER_A);
+}
+
+/*
+ * Stops the PC sampler, the samples taken so far are kept
+ */
+void G8RTOS_StopProfiler(void)
+{
+    if(SysCtlPeripheralReady(PROFILER_TIMER_PERIPH))
+    {
+        TimerDisable(PROFILER_TIMER_BASE, TIMER_A);
+        IntDisable(PROFILER_TIMER_INT);
+    }
+}
+
+/*
+ * Keeps the sample rate after a clock change
+ */
+void G8RTOS_ProfilerClockChanged(uint32_t clockHz)
+{
+    if(ProfileRateHz != 0 && SysCtlPeripheralReady(PROFILER_TIMER_PERIPH))
+    {
+        TimerLoadSet(PROFILER_TIMER_BASE, TIMER_A, clockHz / ProfileRateHz);
+    }
+}
+
+/*
+ * Stops the sampler and prints the capture
+ *  - Lines are kept short, the console is 115200 baud and this runs under the health monitor
+ *  - Checks in every PROFILER_CHECKIN_LINES lines, the whole dump takes longer than a health period
+ */
+void G8RTOS_DumpProfile(void (*print)(const char *format, ...))
+{
+    G8RTOS_StopProfiler();
+
+    print("profile begin %u %u %u\n", ProfileRateHz, NumberOfSamples, MissedSamples);
+    for(uint32_t i = 0;i < NumberOfProfileThreads;i++)
+    {
+        print("thread %x %s\n", profileThreadIDs[i], profileThreadNames[i]);
+    }
+    for(uint32_t i = 0;i < NumberOfSamples;i++)
+    {
+        print("%x %x\n", profileSamples[i].pc, profileSamples[i].ThreadID);
+        if(i % PROFILER_CHECKIN_LINES == PROFILER_CHECKIN_LINES - 1)
+        {
+            G8RTOS_CheckIn();
+        }
+    }
+    print("profile end\n");
+}
+
+/*********************************************** Public Functions *********************************************************************/
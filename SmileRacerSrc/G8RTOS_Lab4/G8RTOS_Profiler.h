@@ -0,0 +1,113 @@
+/**
+ * G8RTOS_Profiler.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_PROFILER_H_
+#define G8RTOS_PROFILER_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Timebase.h"
+
+/*
+ * Build with PROFILE_SCOPES=0 to compile every PROFILE_SCOPE out
+ */
+#ifndef PROFILE_SCOPES
+#define PROFILE_SCOPES 1
+#endif
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define PROFILER_SAMPLES 512
+#define PROFILER_MAX_THREADS 24
+#define PROFILER_RATE_HZ 2000
+#define PROFILER_CHECKIN_LINES 32
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Thread ID recorded for samples that interrupted another handler rather than a thread */
+#define PROFILER_ISR_ID 0
+
+/*
+ * Times the block that follows it into a per-site accumulator
+ *  - PROFILE_SCOPE("draw_wall") { ... }, written as a statement, once per line
+ *  - Reads the cycle counter on entry and hands the difference to G8RTOS_ScopeExit when the block ends
+ *  - Leaving the block with return, break or goto skips the measurement
+ *  - Compiled out, the block is left as a plain block and costs nothing
+ */
+#if PROFILE_SCOPES
+#define PROFILE_SITE_NAME(line) profileSite_##line
+#define PROFILE_SITE(line) PROFILE_SITE_NAME(line)
+#define PROFILE_SCOPE(name) \
+    static profileSite_t PROFILE_SITE(__LINE__) = { name }; \
+    for(uint32_t profileStart = DWT_CYCCNT_R, profileOnce = 1; profileOnce; \
+        profileOnce = 0, G8RTOS_ScopeExit(&PROFILE_SITE(__LINE__), profileStart))
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts a capture of the PC sampler
+ *  - Timer 3A interrupts at "rateHz" above every other interrupt and records the interrupted PC and thread
+ *  - Stops by itself once PROFILER_SAMPLES are taken, PROFILER_SAMPLES / rateHz seconds later
+ *  - Code inside critical sections cannot be sampled, its time lands on the instruction that ends the section
+ * Param "rateHz": Sample rate, a few kHz (PROFILER_RATE_HZ)
+ */
+void G8RTOS_StartProfiler(uint32_t rateHz);
+
+/*
+ * Stops the PC sampler, the samples taken so far are kept
+ */
+void G8RTOS_StopProfiler(void);
+
+/*
+ * Stops the sampler and prints the capture for ProfilerScript/ProfileReport.py
+ *  - One "thread" line per thread seen, then one line per sample, between "profile begin" and "profile end"
+ *  - The host resolves the PCs against the .out, captures from several dumps in one log are added up
+ *  - Calls G8RTOS_CheckIn as it goes, so a health checked thread can dump without a watchdog reset
+ * Param "print": printf-style output function, e.g. UARTprintf
+ */
+void G8RTOS_DumpProfile(void (*print)(const char *format, ...));
+
+/*
+ * Prints every profile site that has run, in the order they first finished
+ *  - Count, min, max and mean in cycles, the mean in us, then the non-empty log2 histogram buckets
+ * Param "print": printf-style output function, e.g. UARTprintf
+ */
+void G8RTOS_DumpProfileScopes(void (*print)(const char *format, ...));
+
+/*
+ * Clears the accumulators of every profile site, the sites stay in the list
+ */
+void G8RTOS_ResetProfileScopes(void);
+
+/*
+ * Adds one run to a profile site, called by PROFILE_SCOPE
+ * Param "site": Site of the scope that finished
+ * Param "start": Cycle count when the scope was entered
+ */
+void G8RTOS_ScopeExit(profileSite_t *site, uint32_t start);
+
+/*
+ * Reloads the sampler timer after a clock change, kernel use only
+ * Param "clockHz": New CPU clock in Hz
+ */
+void G8RTOS_ProfilerClockChanged(uint32_t clockHz);
+
+/*
+ * Sampler interrupt body, entered from Profiler_Handler, kernel use only
+ * Param "frame": Exception frame of the interrupted code
+ * Param "excReturn": EXC_RETURN the sampler was entered with
+ */
+void G8RTOS_ProfilerSample(uint32_t *frame, uint32_t excReturn);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_PROFILER_H_ */
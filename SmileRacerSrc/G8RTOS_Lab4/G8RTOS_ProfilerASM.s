@@ -0,0 +1,35 @@
+; G8RTOS_ProfilerASM.s - uP2 Fall 2022
+; Holds the PC sampler's timer interrupt
+; Note: If you have an h file, do not have a C file and an S file of the same name
+
+	; Functions Defined
+	.def Profiler_Handler
+
+	; Dependencies
+	.ref G8RTOS_ProfilerSample
+
+	.thumb		; Set to thumb mode
+	.align 2	; Align by 2 bytes (thumb mode uses allignment by 2 or 4)
+	.text		; Text section
+
+; Profiler_Handler
+; - Hands the interrupted code's exception frame and EXC_RETURN to G8RTOS_ProfilerSample
+;	- Runs before anything is pushed so R0 points straight at the stacked PC
+;	- Branches instead of calling, the sampler returns from the exception itself
+Profiler_Handler:
+
+	.asmfunc
+
+	TST LR, #4			;EXC_RETURN bit 2 is set if the frame is on PSP
+	ITE EQ
+	MRSEQ R0, MSP		;R0 points at the stacked R0 - R3, R12, LR, PC, xPSR
+	MRSNE R0, PSP
+	MOV R1, LR			;EXC_RETURN, bit 3 tells a thread from a nested handler
+
+	B G8RTOS_ProfilerSample	;Records the sample and returns from the interrupt
+
+	.endasmfunc
+
+	; end of the asm file
+	.align
+	.end
@@ -0,0 +1,50 @@
+/**
+ * G8RTOS_SVC.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_SVC.h"
+#include "G8RTOS_Sections.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Decodes a supervisor call and runs its kernel side
+ *  - The call number is the immediate of the SVC instruction just before the stacked PC
+ *  - Arguments come from the stacked R0 - R2, the result goes back into the stacked R0
+ * Param "frame": Stacked R0 - R3, R12, LR, PC, xPSR of the caller
+ */
+RAMFUNC void G8RTOS_SVCDispatch(uint32_t *frame)
+{
+    uint8_t number = ((uint8_t *)frame[6])[-2];
+
+    switch(number)
+    {
+    case SVC_WAIT:
+        frame[0] = G8RTOS_KernelWait((semaphore_t *)frame[0], frame[1]);
+        break;
+    case SVC_WAIT_CONDITION:
+        frame[0] = G8RTOS_KernelWaitCondition((condition_t *)frame[0], (semaphore_t *)frame[1], frame[2]);
+        break;
+    case SVC_SLEEP:
+        G8RTOS_KernelSleep(frame[0]);
+        break;
+    case SVC_KILL:
+        frame[0] = G8RTOS_KernelKill((threadId_t)frame[0]);
+        break;
+    case SVC_YIELD:
+        G8RTOS_KernelYield();
+        break;
+    default:
+        break;
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
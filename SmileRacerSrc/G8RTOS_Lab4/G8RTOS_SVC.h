@@ -0,0 +1,59 @@
+/**
+ * G8RTOS_SVC.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_SVC_H_
+#define G8RTOS_SVC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Semaphores.h"
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Supervisor call numbers, the immediates in G8RTOS_SVCASM.s */
+#define SVC_WAIT            0
+#define SVC_WAIT_CONDITION  1
+#define SVC_SLEEP           2
+#define SVC_KILL            3
+#define SVC_YIELD           4
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Supervisor call stubs, kernel use only
+ *  - Each one enters the kernel through SVCall so the call and the context switch it causes are one exception
+ *  - Only call from threads with interrupts enabled, an SVC from a critical section or an ISR hard faults
+ */
+bool G8RTOS_SVCWait(semaphore_t *s, uint32_t timeoutMS);
+bool G8RTOS_SVCWaitCondition(condition_t *c, semaphore_t *mutex, uint32_t timeoutMS);
+void G8RTOS_SVCSleep(uint32_t durationUs);
+sched_ErrCode_t G8RTOS_SVCKill(threadId_t threadID);
+void G8RTOS_SVCYield(void);
+
+/*
+ * Kernel side of each supervisor call, run by the dispatcher in handler mode
+ *  - Each may pend PendSV, the switch happens as the SVC returns
+ */
+bool G8RTOS_KernelWait(semaphore_t *s, uint32_t timeoutMS);
+bool G8RTOS_KernelWaitCondition(condition_t *c, semaphore_t *mutex, uint32_t timeoutMS);
+void G8RTOS_KernelSleep(uint32_t durationUs);
+sched_ErrCode_t G8RTOS_KernelKill(threadId_t threadID);
+void G8RTOS_KernelYield(void);
+
+/*
+ * Decodes a supervisor call and runs its kernel side
+ *  - Called by SVC_Handler with the caller's exception frame
+ * Param "frame": Stacked R0 - R3, R12, LR, PC, xPSR of the caller
+ */
+void G8RTOS_SVCDispatch(uint32_t *frame);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_SVC_H_ */
@@ -0,0 +1,76 @@
+; G8RTOS_SVCASM.s - uP2 Fall 2022
+; Holds the supervisor call stubs and the SVCall handler
+; Note: If you have an h file, do not have a C file and an S file of the same name
+
+	; Functions Defined
+	.def G8RTOS_SVCWait, G8RTOS_SVCWaitCondition, G8RTOS_SVCSleep, G8RTOS_SVCKill, G8RTOS_SVCYield, SVC_Handler
+
+	; Dependencies
+	.ref G8RTOS_SVCDispatch
+
+	.thumb		; Set to thumb mode
+	.align 2	; Align by 2 bytes (thumb mode uses allignment by 2 or 4)
+	.text		; Text section
+
+; Supervisor call stubs
+;	- Arguments are already in R0 - R3, the exception stacks them for the dispatcher
+;	- The immediate is the call number, it must match the SVC_ defines in G8RTOS_SVC.h
+;	- The dispatcher's result comes back in R0
+G8RTOS_SVCWait:
+	.asmfunc
+	SVC #0				;SVC_WAIT
+	BX LR
+	.endasmfunc
+
+G8RTOS_SVCWaitCondition:
+	.asmfunc
+	SVC #1				;SVC_WAIT_CONDITION
+	BX LR
+	.endasmfunc
+
+G8RTOS_SVCSleep:
+	.asmfunc
+	SVC #2				;SVC_SLEEP
+	BX LR
+	.endasmfunc
+
+G8RTOS_SVCKill:
+	.asmfunc
+	SVC #3				;SVC_KILL
+	BX LR
+	.endasmfunc
+
+G8RTOS_SVCYield:
+	.asmfunc
+	SVC #4				;SVC_YIELD
+	BX LR
+	.endasmfunc
+
+	.sect ".ramfunc"	; Handler runs from SRAM, see G8RTOS_Sections.h
+
+; SVC_Handler
+; - Hands the caller's stacked registers to G8RTOS_SVCDispatch
+;	- Picks the stack the exception frame went to (threads run on MSP)
+;	- A context switch pended by the call tail-chains into PendSV before the thread runs again
+SVC_Handler:
+
+	.asmfunc
+
+	TST LR, #4			;EXC_RETURN bit 2 is set if the frame is on PSP
+	ITE EQ
+	MRSEQ R0, MSP		;R0 points at the stacked R0 - R3, R12, LR, PC, xPSR
+	MRSNE R0, PSP
+
+	PUSH {R4, LR}		;Protect LR, R4 keeps the stack 8 byte aligned
+
+	BL G8RTOS_SVCDispatch	;Calling the dispatcher
+
+	POP {R4, LR}		;Restore LR
+
+	BX LR				;Returns, or tail-chains into PendSV
+
+	.endasmfunc
+
+	; end of the asm file
+	.align
+	.end
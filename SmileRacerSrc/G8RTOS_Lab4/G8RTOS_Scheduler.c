@@ -6,13 +6,23 @@
 #include "inc/hw_types.h"
 #include "inc/hw_ints.h"
 #include "inc/hw_nvic.h"
+#include "inc/hw_memmap.h"
 #include "driverlib/systick.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+#include "driverlib/mpu.h"
+#include "driverlib/cpu.h"
 #include "BoardSupport/inc/RGBLedDriver.h"
 #include "G8RTOS_Scheduler.h"
 #include "G8RTOS_Structures.h"
 #include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_SVC.h"
+#include "G8RTOS_Sections.h"
+#include "G8RTOS_Fault.h"
+#include "G8RTOS_Health.h"
+#include "G8RTOS_Profiler.h"
 
 /*
  * G8RTOS_Start exists in asm
@@ -35,6 +45,14 @@ extern uint32_t SystemCoreClock;
 /* Status Register with the Thumb-bit Set */
 #define THUMBBIT 0x01000000
 
+/* Utilization is kept in hundredths of a percent */
+#define UTILIZATION_FULL 10000
+
+/* One-shot timer that wakes the front of the sleep queue */
+#define WAKE_TIMER_BASE         TIMER2_BASE
+#define WAKE_TIMER_PERIPH       SYSCTL_PERIPH_TIMER2
+#define WAKE_TIMER_INT          INT_TIMER2A
+
 /*********************************************** Defines ******************************************************************************/
 
 
@@ -47,7 +65,10 @@ static tcb_t threadControlBlocks[MAX_THREADS];
 
 /* Thread Stacks
  *  - An array of arrays that will act as individual stacks for each thread
+ *  - The bottom STACK_GUARD_BYTES of the running thread's stack is a no-access MPU region
+ *  - Aligned so every stack starts on a guard region boundary
  */
+#pragma DATA_ALIGN(threadStacks, STACK_GUARD_BYTES)
 static int32_t threadStacks[MAX_THREADS][STACKSIZE];
 
 /* Periodic Event Threads
@@ -55,6 +76,11 @@ static int32_t threadStacks[MAX_THREADS][STACKSIZE];
  */
 static ptcb_t Pthread[MAXPTHREADS];
 
+/* Rate Monotonic Bounds
+ *  - Liu and Layland bound n(2^(1/n) - 1) for n periodic events, in hundredths of a percent
+ */
+static const uint16_t RateMonotonicBound[MAXPTHREADS] = {10000, 8284, 7798, 7568, 7435, 7348};
+
 /*********************************************** Data Structures Used *****************************************************************/
 
 
@@ -70,6 +96,48 @@ static uint32_t NumberOfThreads;
  */
 static uint32_t NumberOfPthreads;
 
+/*
+ * Sum of the periodic events' budget over period, in hundredths of a percent
+ */
+static uint32_t PeriodicUtilization;
+
+/*
+ * Time a thread may stay ready without running before it is boosted, 0 disables aging
+ */
+static uint32_t AgingThreshold;
+
+/*
+ * Priority levels added to a starving thread each time it crosses the aging threshold
+ */
+static uint8_t AgingBoost;
+
+/*
+ * Ticks a thread runs before the scheduler round robins to a ready thread of equal priority
+ */
+static uint32_t TimeSliceQuantum = DEFAULT_QUANTUM;
+
+/*
+ * Ticks the running thread has used of its quantum
+ */
+static uint32_t QuantumTicks;
+
+/*
+ * Number of times the scheduler has run
+ */
+static uint32_t ContextSwitches;
+
+/*
+ * Set once G8RTOS_Launch hands the CPU to the first thread
+ */
+static bool KernelRunning;
+
+/*
+ * Sleep queue
+ *  - Sleeping threads and timed waits linked by nextSleeping, earliest wake time first
+ *  - Wake times are in microseconds, the wake timer only ever looks at the front
+ */
+static tcb_t *SleepQueue;
+
 /*********************************************** Private Variables ********************************************************************/
 
 
@@ -86,13 +154,101 @@ static void InitSysTick(uint32_t numCycles)
     SysTickEnable();
 }
 
+/*
+ * Moves the stack guard to the bottom of a thread's stack
+ *  - An overflow touches the guard before the stack below it and raises MemManage
+ * Param "thread": Thread about to run
+ */
+static inline void SetStackGuard(tcb_t *thread)
+{
+    MPURegionSet(STACK_GUARD_REGION, (uint32_t)&threadStacks[thread - threadControlBlocks][0],
+                 MPU_RGN_SIZE_32B | MPU_RGN_PERM_NOEXEC | MPU_RGN_PERM_PRV_NO_USR_NO | MPU_RGN_ENABLE);
+}
+
+/*
+ * Loads the wake timer for the front of the sleep queue
+ *  - Stops it when the queue is empty
+ *  - A wake time already passed fires on the next microsecond
+ *  - Waits longer than the 32-bit timer can count fire early and re-arm
+ *  - Caller must hold a critical section
+ */
+static void ArmWakeTimer(void)
+{
+    if(KernelRunning == false)
+    {
+        return;                                     //Launch arms it once the timer is set up
+    }
+
+    TimerDisable(WAKE_TIMER_BASE, TIMER_A);
+    if(SleepQueue == 0)
+    {
+        return;
+    }
+
+    int32_t remaining = (int32_t)(SleepQueue->sleepCount - (uint32_t)G8RTOS_GetTimeUs());
+    uint32_t cyclesPerUs = G8RTOS_GetCyclesPerUs();
+    if(remaining < 1)
+    {
+        remaining = 1;
+    }
+    if((uint32_t)remaining > 0xFFFFFFFF / cyclesPerUs)
+    {
+        remaining = 0xFFFFFFFF / cyclesPerUs;
+    }
+
+    TimerLoadSet(WAKE_TIMER_BASE, TIMER_A, remaining * cyclesPerUs);
+    TimerEnable(WAKE_TIMER_BASE, TIMER_A);
+}
+
+/*
+ * Wake timer interrupt
+ *  - Wakes every thread off the front of the sleep queue that is due
+ *  - A timed wait that expired gives back the count it took
+ *  - Starts a context switch if a woken thread is at least the running thread's priority
+ */
+RAMFUNC static void WakeTimer_Handler(void)
+{
+    TimerIntClear(WAKE_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+
+    int32_t IBit_State = StartCriticalSection();
+    uint32_t now = (uint32_t)G8RTOS_GetTimeUs();
+    bool reschedule = false;
+
+    //Nothing behind the first thread still asleep is due
+    while(SleepQueue != 0 && G8RTOS_TIME_AFTER_EQ(now, SleepQueue->sleepCount))
+    {
+        tcb_t *ptr = SleepQueue;
+        SleepQueue = ptr->nextSleeping;
+        ptr->nextSleeping = 0;
+        ptr->asleep = 0;
+        if(ptr->blocked != 0)               //Timed wait expired, give back the count it took
+        {
+            *(ptr->blocked) += 1;
+            ptr->blocked = UNBLOCKED;
+            ptr->timedOut = true;
+        }
+        if(ptr->priority <= CurrentlyRunningThread->priority)
+        {
+            reschedule = true;
+        }
+    }
+
+    ArmWakeTimer();
+    EndCriticalSection(IBit_State);
+
+    if(reschedule)
+    {
+        HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+    }
+}
+
 /*
  * Chooses the next thread to run.
  * Lab 2 Scheduling Algorithm:
  *  - Simple Round Robin: Choose the next running thread by selecting the currently running thread's next pointer
  *  - Check for sleeping and blocked threads
  */
-void G8RTOS_Scheduler()
+RAMFUNC void G8RTOS_Scheduler()
 {
     currentMaxPriority = 256;                                               //Sets a max priority
     tempNextThread = CurrentlyRunningThread->nextTCB;                       //Sets a temp next thread
@@ -100,7 +256,9 @@ void G8RTOS_Scheduler()
     {
         if(tempNextThread->asleep == 0 && tempNextThread->blocked == 0)     //Checks if alive or blocked
         {
-            if(tempNextThread->priority < currentMaxPriority)               //Checks priority
+            if(tempNextThread->priority < currentMaxPriority                //Checks priority, EDF ties go to the earlier deadline
+               || (tempNextThread->priority == currentMaxPriority && tempNextThread->isEDF && CurrentlyRunningThread->isEDF
+                   && G8RTOS_TIME_BEFORE(tempNextThread->deadline, CurrentlyRunningThread->deadline)))
             {
                 CurrentlyRunningThread = tempNextThread;                    //Assigns max priority
                 currentMaxPriority = CurrentlyRunningThread->priority;      //New max priority
@@ -108,46 +266,95 @@ void G8RTOS_Scheduler()
         }
         tempNextThread = tempNextThread->nextTCB;
     }
+    CurrentlyRunningThread->priority = CurrentlyRunningThread->basePriority;   //Drops any aging boost once it runs
+    SetStackGuard(CurrentlyRunningThread);                                      //Guards the incoming thread's stack
+    QuantumTicks = 0;                                                           //Starts a new quantum
+    ContextSwitches++;
 }
 
 
 /*
  * SysTick Handler
  * The Systick Handler now will increment the system time,
- * set the PendSV flag to start the scheduler,
- * and be responsible for handling sleeping and periodic threads
+ * be responsible for handling sleeping and periodic threads,
+ * and set the PendSV flag only when the scheduler could pick a different thread:
+ *  - A ready thread outranks the running one, e.g. once the running thread's aging boost was dropped
+ *    or an EDF peer has the earlier deadline
+ *  - A thread was aged to at least the running thread's priority
+ *  - The running thread used up its quantum and a thread of equal priority is ready
  */
-void SysTick_Handler()
+RAMFUNC void SysTick_Handler()
 {
     SystemTime++;
+    G8RTOS_GetCycles();             //Keeps the 64-bit cycle count extended
     tcb_t *ptr = CurrentlyRunningThread;
+    bool reschedule = false;
+    bool peerReady = false;
 
     ptcb_t *Pptr = &Pthread[0]; //Checks for periodic threads, and executes them appropriately
     for(uint8_t i = 0;i < NumberOfPthreads;i++)
     {
-        if(Pptr->executeTime == SystemTime)
+        if(G8RTOS_TIME_AFTER_EQ(SystemTime, Pptr->executeTime))
         {
             Pptr->executeTime = Pptr->period + SystemTime;
+            uint32_t start = G8RTOS_GetCycleCount();
             Pptr->handler();
+            uint32_t cycles = G8RTOS_GetCycleCount() - start;   //Measures the run against its budget
+            if(cycles > Pptr->maxCycles)
+            {
+                Pptr->maxCycles = cycles;
+            }
+            if(cycles > Pptr->budgetUs * G8RTOS_GetCyclesPerUs())
+            {
+                Pptr->overruns++;
+            }
         }
         Pptr = Pptr->nextPTCB;
     }
 
-    //Checks sleeping threads and wakes them up appropriately
+    ptr = CurrentlyRunningThread;
     for(uint8_t i = 0;i < NumberOfThreads;i++)
     {
-        if(ptr->asleep == 1)
+        if(ptr->asleep == 0 && ptr->blocked == 0 && G8RTOS_Preempts(ptr))
         {
-            if(ptr->sleepCount == SystemTime)
+            reschedule = true;
+        }
+
+        //Ages threads that are ready but not running, waiting threads are not starving and EDF threads stay in their band
+        if(ptr == CurrentlyRunningThread || ptr->asleep == 1 || ptr->blocked != 0 || ptr->isEDF)
+        {
+            ptr->readySince = SystemTime;
+        }
+        else
+        {
+            if(AgingThreshold != 0 && SystemTime - ptr->readySince >= AgingThreshold)
+            {
+                ptr->priority = (ptr->priority > AgingBoost) ? ptr->priority - AgingBoost : 0;
+                ptr->readySince = SystemTime;
+                if(ptr->priority <= CurrentlyRunningThread->priority)
+                {
+                    reschedule = true;
+                }
+            }
+            if(ptr->priority == CurrentlyRunningThread->priority)
             {
-                ptr->asleep = 0;
-                ptr->sleepCount = 0;
+                peerReady = true;
             }
         }
         ptr = ptr->nextTCB;
     }
 
-    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+    //Round robins between equal priorities once the quantum is used up
+    QuantumTicks++;
+    if(QuantumTicks >= TimeSliceQuantum && peerReady)
+    {
+        reschedule = true;
+    }
+
+    if(reschedule || CurrentlyRunningThread->asleep == 1 || CurrentlyRunningThread->blocked != 0)
+    {
+        HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+    }
 }
 
 /*********************************************** Private Functions ********************************************************************/
@@ -184,6 +391,8 @@ void G8RTOS_Init()
     }
 
     HWREG(NVIC_VTABLE) = newVTORTable;
+
+    G8RTOS_InitTimebase();
 }
 
 /*
@@ -205,10 +414,28 @@ int G8RTOS_Launch()
         }
     }
 
+    //Guards the first thread's stack, the default map covers everything else
+    SetStackGuard(CurrentlyRunningThread);
+    MPUEnable(MPU_CONFIG_PRIV_DEFAULT);
+    IntPrioritySet(FAULT_MPU, 0x00);
+    IntEnable(FAULT_MPU);
+
     InitSysTick(SysCtlClockGet() / 1000); // 1 ms tick (1Hz / 1000)
     IntPrioritySet(FAULT_PENDSV, 0xE0);
     IntPrioritySet(FAULT_SYSTICK, 0xE0);
+    IntPrioritySet(FAULT_SVCALL, 0xE0);   //Kernel calls run at the same level as the switch they pend
     SysTickIntEnable();
+
+    //Full width one-shot, same priority as the tick so it never preempts a context switch
+    SysCtlPeripheralEnable(WAKE_TIMER_PERIPH);
+    TimerConfigure(WAKE_TIMER_BASE, TIMER_CFG_ONE_SHOT);
+    TimerIntEnable(WAKE_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    ((uint32_t *)HWREG(NVIC_VTABLE))[WAKE_TIMER_INT] = (uint32_t)WakeTimer_Handler;
+    IntPrioritySet(WAKE_TIMER_INT, 0xE0);
+    IntEnable(WAKE_TIMER_INT);
+
+    KernelRunning = true;
+    ArmWakeTimer();                       //Threads may have queued timed waits before launch
     IntMasterEnable();
 
     G8RTOS_Start();
@@ -274,12 +501,24 @@ sched_ErrCode_t G8RTOS_AddThread(void (*threadToAdd)(void), uint8_t priority, ch
             nameIndex++;
         }
         threadControlBlocks[newThreadIndex].asleep = false;
+        threadControlBlocks[newThreadIndex].blocked = UNBLOCKED;
+        threadControlBlocks[newThreadIndex].timedOut = false;
+        threadControlBlocks[newThreadIndex].nextSleeping = 0;
         threadControlBlocks[newThreadIndex].priority = priority;
+        threadControlBlocks[newThreadIndex].basePriority = priority;
+        threadControlBlocks[newThreadIndex].readySince = SystemTime;
+        threadControlBlocks[newThreadIndex].isEDF = false;
         threadControlBlocks[newThreadIndex].isAlive = 1;
         threadControlBlocks[newThreadIndex].stackPointer = &threadStacks[newThreadIndex][STACKSIZE-16];   //Sets the stack pointer to the thread
         threadStacks[newThreadIndex][STACKSIZE-1] = THUMBBIT;                //xPSR
         threadStacks[newThreadIndex][STACKSIZE-2] = (uint32_t)threadToAdd;   //PC
         NumberOfThreads++;  //Increases the thread count
+
+        //The tick no longer reschedules every time, so preempt now if the new thread outranks us
+        if(KernelRunning && priority < CurrentlyRunningThread->priority)
+        {
+            HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+        }
     }
     EndCriticalSection(IBit_State);
     return NO_ERROR;
@@ -290,19 +529,30 @@ sched_ErrCode_t G8RTOS_AddThread(void (*threadToAdd)(void), uint8_t priority, ch
  * Adds periodic threads to G8RTOS Scheduler
  * Function will initialize a periodic event struct to represent event.
  * The struct will be added to a linked list of periodic events
+ *  - Rejects the event if the budgets would exceed the rate monotonic bound for the new event count
  * Param Pthread To Add: void-void function for P thread handler
  * Param period: period of P thread to add
+ * Param execution: SystemTime of the first release
+ * Param budgetUs: worst-case execution time of the handler in us
  * Returns: Error code for adding threads
  */
-int G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t period, uint32_t execution)
+sched_ErrCode_t G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t period, uint32_t execution, uint32_t budgetUs)
 {
     IBit_State = StartCriticalSection();
 
     //Maximum amount of P threads
-    if(NumberOfPthreads > MAXPTHREADS)
+    if(NumberOfPthreads >= MAXPTHREADS)
     {
         EndCriticalSection(IBit_State);
-        return -1;  //Return -1 if at max
+        return PERIODIC_LIMIT_REACHED;
+    }
+
+    //Budget over period, rounded up so a borderline set is rejected
+    uint32_t utilization = (period > 0) ? (budgetUs * (UTILIZATION_FULL / 1000) + period - 1) / period : UTILIZATION_FULL + 1;
+    if(PeriodicUtilization + utilization > RateMonotonicBound[NumberOfPthreads])
+    {
+        EndCriticalSection(IBit_State);
+        return PERIODIC_OVERLOAD;
     }
     else
     {
@@ -321,10 +571,42 @@ int G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t period, uint32_
         Pthread[NumberOfPthreads].period = period;          //Stores period
         Pthread[NumberOfPthreads].executeTime = execution;  //Stores execution
         Pthread[NumberOfPthreads].handler = PthreadToAdd;   //Stores handler
+        Pthread[NumberOfPthreads].budgetUs = budgetUs;      //Stores budget
+        Pthread[NumberOfPthreads].maxCycles = 0;
+        Pthread[NumberOfPthreads].overruns = 0;
+        PeriodicUtilization += utilization;
         NumberOfPthreads++; //Increases thread count
     }
     EndCriticalSection(IBit_State);
-    return 1;
+    return NO_ERROR;
+}
+
+/*
+ * Copies the budget and measured execution of a periodic event
+ * Returns: Error code if no event has that handler
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicStats(void (*PthreadToFind)(void), ptcb_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+    for(uint8_t i = 0;i < NumberOfPthreads;i++)
+    {
+        if(Pthread[i].handler == PthreadToFind)
+        {
+            *stats = Pthread[i];
+            EndCriticalSection(IBit_State);
+            return NO_ERROR;
+        }
+    }
+    EndCriticalSection(IBit_State);
+    return THREAD_DOES_NOT_EXIST;
+}
+
+/*
+ * Returns the periodic events' share of the CPU in hundredths of a percent, from their budgets
+ */
+uint32_t G8RTOS_GetPeriodicUtilization(void)
+{
+    return PeriodicUtilization;
 }
 
 sched_ErrCode_t G8RTOS_AddAPeriodicEvent(void (*AthreadToAdd)(void), uint8_t priority, int32_t IRQn)
@@ -360,9 +642,150 @@ sched_ErrCode_t G8RTOS_AddAPeriodicEvent(void (*AthreadToAdd)(void), uint8_t pri
  */
 void sleep(uint32_t durationMS)
 {
-    CurrentlyRunningThread->sleepCount = durationMS + SystemTime;   //Sets sleep count
-    CurrentlyRunningThread->asleep = 1;                             //Puts the thread to sleep
-    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;                  //Start context switch
+    G8RTOS_SleepUs(durationMS * 1000);
+}
+
+/*
+ * Puts the current thread into a sleep state with microsecond resolution
+ *  param durationUs: Duration of sleep time in us
+ */
+void G8RTOS_SleepUs(uint32_t durationUs)
+{
+    G8RTOS_SVCSleep(durationUs);
+}
+
+/*
+ * Returns true if the caller may make a blocking kernel call
+ *  - Needs a running kernel, thread mode and interrupts on, the SVC would escalate to a HardFault otherwise
+ */
+bool G8RTOS_CanBlock(void)
+{
+    return KernelRunning
+        && (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M) == 0
+        && CPUprimask() == 0;
+}
+
+/*
+ * Waits at least "us" microseconds
+ *  - Sleeps only where G8RTOS_CanBlock allows it
+ */
+void G8RTOS_DelayUs(uint32_t us)
+{
+    if(us >= DELAY_SLEEP_THRESHOLD_US && G8RTOS_CanBlock())
+    {
+        G8RTOS_SleepUs(us);
+    }
+    else
+    {
+        G8RTOS_SpinUs(us);
+    }
+}
+
+/*
+ * Waits at least "ms" milliseconds
+ */
+void G8RTOS_DelayMs(uint32_t ms)
+{
+    G8RTOS_DelayUs(ms * 1000);
+}
+
+/*
+ * Kernel side of G8RTOS_SleepUs
+ *  - The wake timer is reloaded if this thread is now first to wake
+ *  param durationUs: Duration of sleep time in us
+ */
+void G8RTOS_KernelSleep(uint32_t durationUs)
+{
+    int32_t IBit_State = StartCriticalSection();
+    G8RTOS_SleepQueueInsert(CurrentlyRunningThread, (uint32_t)G8RTOS_GetTimeUs() + durationUs);  //Puts the thread to sleep
+    EndCriticalSection(IBit_State);
+    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;                              //Start context switch
+}
+
+/*
+ * Inserts a thread into the sleep queue, kernel use only
+ *  - Keeps the queue sorted by wake time, threads due at the same time stay in insertion order
+ *  - Re-arms the wake timer when the thread goes to the front
+ *  - Caller must hold a critical section
+ * Param "thread": Thread to put to sleep
+ * Param "wakeTime": Time in us (G8RTOS_GetTimeUs) to wake the thread at
+ */
+void G8RTOS_SleepQueueInsert(tcb_t *thread, uint32_t wakeTime)
+{
+    thread->sleepCount = wakeTime;
+    thread->asleep = 1;
+
+    tcb_t **link = &SleepQueue;
+    while(*link != 0 && G8RTOS_TIME_AFTER_EQ(wakeTime, (*link)->sleepCount))
+    {
+        link = &((*link)->nextSleeping);
+    }
+    thread->nextSleeping = *link;
+    *link = thread;
+
+    if(SleepQueue == thread)
+    {
+        ArmWakeTimer();
+    }
+}
+
+/*
+ * Removes a thread from the sleep queue before its wake time, kernel use only
+ *  - Caller must hold a critical section
+ * Param "thread": Thread to take out of the queue
+ */
+void G8RTOS_SleepQueueRemove(tcb_t *thread)
+{
+    bool wasFirst = (SleepQueue == thread);
+    tcb_t **link = &SleepQueue;
+    while(*link != 0)
+    {
+        if(*link == thread)
+        {
+            *link = thread->nextSleeping;
+            break;
+        }
+        link = &((*link)->nextSleeping);
+    }
+    thread->nextSleeping = 0;
+    thread->asleep = 0;
+
+    if(wasFirst)
+    {
+        ArmWakeTimer();
+    }
+}
+
+/*
+ * Checks if a ready thread should run before the running thread, kernel use only
+ *  - A numerically lower priority wins
+ *  - Between two EDF threads of the same priority, the earlier deadline wins
+ * Param "thread": Ready thread to compare
+ */
+bool G8RTOS_Preempts(tcb_t *thread)
+{
+    if(thread->priority != CurrentlyRunningThread->priority)
+    {
+        return thread->priority < CurrentlyRunningThread->priority;
+    }
+    return thread->isEDF && CurrentlyRunningThread->isEDF
+           && G8RTOS_TIME_BEFORE(thread->deadline, CurrentlyRunningThread->deadline);
+}
+
+/*
+ * Tells the kernel the CPU clock changed
+ *  - Moves the timebase to the new rate first, everything below converts time with it
+ *  - Reloads the tick for 1 ms, re-arms the wake timer and updates the watchdog and profiler timers
+ */
+void G8RTOS_ClockChanged(uint32_t clockHz)
+{
+    int32_t IBit_State = StartCriticalSection();
+    G8RTOS_SetTimebaseClock(clockHz);
+    SysTickPeriodSet(clockHz / 1000);
+    ArmWakeTimer();
+    G8RTOS_HealthClockChanged(clockHz);
+    G8RTOS_ProfilerClockChanged(clockHz);
+    EndCriticalSection(IBit_State);
 }
 
 threadId_t G8RTOS_GetThreadId()
@@ -372,7 +795,37 @@ threadId_t G8RTOS_GetThreadId()
 
 sched_ErrCode_t G8RTOS_KillThread(threadId_t threadID)
 {
-    IBit_State = StartCriticalSection();            //Disables interrupts
+    return G8RTOS_SVCKill(threadID);                //Kernel kills it, switches away if it was us
+}
+
+//Thread kills itself
+sched_ErrCode_t G8RTOS_KillSelf()
+{
+    sched_ErrCode_t err = G8RTOS_SVCKill(CurrentlyRunningThread->ThreadID);
+    if(err != NO_ERROR)                             //Only returns if it can't be killed
+    {
+        return err;
+    }
+    while(1);
+}
+
+/*
+ * Gives up the rest of the quantum to another ready thread of equal or higher priority
+ */
+void G8RTOS_Yield(void)
+{
+    G8RTOS_SVCYield();
+}
+
+/*
+ * Kernel side of G8RTOS_KillThread and G8RTOS_KillSelf
+ *  - Unlinks the thread and drops it from the sleep queue
+ *  - A thread killing itself switches away as the SVC returns
+ * Returns: Error code for killing threads
+ */
+sched_ErrCode_t G8RTOS_KernelKill(threadId_t threadID)
+{
+    int32_t IBit_State = StartCriticalSection();    //Disables interrupts
     tcb_t *tempThread = CurrentlyRunningThread;
     if(NumberOfThreads == 1)                        //Can't kill the last thread
     {
@@ -391,45 +844,177 @@ sched_ErrCode_t G8RTOS_KillThread(threadId_t threadID)
             }
             tempThread->previousTCB->nextTCB = tempThread->nextTCB;     //Revises linked list
             tempThread->nextTCB->previousTCB = tempThread->previousTCB;
+            if(tempThread->asleep)                                      //Drops it from the sleep queue
+            {
+                G8RTOS_SleepQueueRemove(tempThread);
+            }
+            EndCriticalSection(IBit_State);
             if(tempThread == CurrentlyRunningThread)                    //If currently running thread, initiate context switch
             {
-                EndCriticalSection(IBit_State);
                 HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
             }
-            else
+            return NO_ERROR;
+        }
+        tempThread = tempThread->nextTCB;
+    }
+
+    EndCriticalSection(IBit_State);
+    return THREAD_DOES_NOT_EXIST;
+}
+
+/*
+ * Kernel side of G8RTOS_Yield
+ *  - The scheduler starts its search after the running thread, so an equal priority peer goes next
+ */
+void G8RTOS_KernelYield(void)
+{
+    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+}
+
+/*
+ * Changes the priority of a thread at runtime
+ *  - Sets the base priority and drops any aging boost
+ *  - Starts a context switch so the change takes effect right away
+ * Param "threadID": ID of the thread to change
+ * Param "priority": New priority, 0 is the highest
+ * Returns: Error code if the thread does not exist
+ */
+sched_ErrCode_t G8RTOS_SetPriority(threadId_t threadID, uint8_t priority)
+{
+    int32_t IBit_State = StartCriticalSection();
+    tcb_t *tempThread = CurrentlyRunningThread;
+    for(uint8_t i = 0;i < NumberOfThreads;i++)      //Find the thread in the list of threads
+    {
+        if(tempThread->ThreadID == threadID)
+        {
+            tempThread->basePriority = priority;
+            tempThread->priority = priority;
+            tempThread->readySince = SystemTime;
+            EndCriticalSection(IBit_State);
+            if(KernelRunning)
             {
-                EndCriticalSection(IBit_State);
-                return NO_ERROR;
+                HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
             }
+            return NO_ERROR;
         }
-
+        tempThread = tempThread->nextTCB;
     }
-
     EndCriticalSection(IBit_State);
     return THREAD_DOES_NOT_EXIST;
 }
 
-//Thread kills itself
-sched_ErrCode_t G8RTOS_KillSelf()
+/*
+ * Configures priority aging
+ *  - A thread ready for "thresholdMS" without running is raised "boost" levels, repeatedly until it runs
+ *  - The boost is dropped as soon as the scheduler picks the thread
+ * Param "thresholdMS": Ready time before a boost, 0 disables aging
+ * Param "boost": Levels added per threshold crossed
+ */
+void G8RTOS_SetAging(uint32_t thresholdMS, uint8_t boost)
 {
-    IBit_State = StartCriticalSection();
-    if(NumberOfThreads == 1)                //Can't kill the last thread
+    int32_t IBit_State = StartCriticalSection();
+    AgingThreshold = thresholdMS;
+    AgingBoost = boost;
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Sets the time slice quantum
+ *  - Threads of equal priority round robin every "quantumMS" ticks
+ *  - The tick only starts a context switch when the quantum is up and a peer is ready
+ * Param "quantumMS": Ticks per quantum, at least 1
+ */
+void G8RTOS_SetQuantum(uint32_t quantumMS)
+{
+    TimeSliceQuantum = (quantumMS > 0) ? quantumMS : 1;
+}
+
+/*
+ * Returns the number of times the scheduler has run since launch
+ */
+uint32_t G8RTOS_GetContextSwitchCount(void)
+{
+    return ContextSwitches;
+}
+
+/*
+ * Adds a periodic thread to the earliest-deadline-first band
+ *  - First job is released right away
+ * Returns: Error code for adding threads
+ */
+sched_ErrCode_t G8RTOS_AddEDFThread(void (*threadToAdd)(void), uint32_t periodMS, uint32_t deadlineMS, char *name)
+{
+    int32_t IBit_State = StartCriticalSection();        //Keeps the new thread from running before it is EDF
+    sched_ErrCode_t err = G8RTOS_AddThread(threadToAdd, EDF_PRIORITY, name);
+    if(err != NO_ERROR)
     {
         EndCriticalSection(IBit_State);
-        return CANNOT_KILL_LAST_THREAD;
+        return err;
+    }
+
+    //AddThread links a new thread right after the running one, or makes it the running one if it is the first
+    tcb_t *thread = (NumberOfThreads == 1) ? CurrentlyRunningThread : CurrentlyRunningThread->nextTCB;
+    thread->isEDF = true;
+    thread->period = periodMS;
+    thread->relativeDeadline = (deadlineMS > 0 && deadlineMS < periodMS) ? deadlineMS : periodMS;
+    thread->release = SystemTime;
+    thread->deadline = SystemTime + thread->relativeDeadline;
+    thread->jobs = 0;
+    thread->deadlineMisses = 0;
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Ends the current job of an EDF thread and sleeps until its next release
+ */
+void G8RTOS_WaitNextPeriod(void)
+{
+    tcb_t *thread = CurrentlyRunningThread;
+
+    int32_t IBit_State = StartCriticalSection();
+    thread->jobs++;
+    if(G8RTOS_TIME_BEFORE(thread->deadline, SystemTime))
+    {
+        thread->deadlineMisses++;
     }
-    NumberOfThreads--;                      //Decrements number of threads
-    CurrentlyRunningThread->isAlive = 0;    //Deletes thread parameters
-    for(uint8_t i = 0;i < MAX_NAME_LENGTH;i++)
+
+    thread->release += thread->period;
+    if(G8RTOS_TIME_BEFORE(thread->release, SystemTime))     //Overran a whole period, release now instead
     {
-        CurrentlyRunningThread->Threadname[i] = 0;
+        thread->release = SystemTime;
     }
-    CurrentlyRunningThread->previousTCB->nextTCB = CurrentlyRunningThread->nextTCB; //Revises linked list
-    CurrentlyRunningThread->nextTCB->previousTCB = CurrentlyRunningThread->previousTCB;
+    thread->deadline = thread->release + thread->relativeDeadline;
+    uint32_t wait = thread->release - SystemTime;
     EndCriticalSection(IBit_State);
 
-    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;    //Initiates context switch
-    while(1);
+    if(wait > 0)
+    {
+        sleep(wait);
+    }
+}
+
+/*
+ * Copies the job and deadline miss counts of an EDF thread
+ * Returns: Error code if the thread does not exist
+ */
+sched_ErrCode_t G8RTOS_GetEDFStats(threadId_t threadID, uint32_t *jobs, uint32_t *deadlineMisses)
+{
+    int32_t IBit_State = StartCriticalSection();
+    tcb_t *tempThread = CurrentlyRunningThread;
+    for(uint8_t i = 0;i < NumberOfThreads;i++)      //Find the thread in the list of threads
+    {
+        if(tempThread->ThreadID == threadID && tempThread->isEDF)
+        {
+            *jobs = tempThread->jobs;
+            *deadlineMisses = tempThread->deadlineMisses;
+            EndCriticalSection(IBit_State);
+            return NO_ERROR;
+        }
+        tempThread = tempThread->nextTCB;
+    }
+    EndCriticalSection(IBit_State);
+    return THREAD_DOES_NOT_EXIST;
 }
 
 uint32_t GetNumberOfThreads(void)
@@ -449,12 +1034,16 @@ void G8RTOS_KillAllThreads()
             temp->Threadname[i] = 0;
 
         temp->isAlive = false;
+        temp->asleep = false;
+        temp->nextSleeping = 0;
         NumberOfThreads--;
         temp = temp->nextTCB;
     } while(temp != CurrentlyRunningThread);
 
     CurrentlyRunningThread->nextTCB = CurrentlyRunningThread;
     CurrentlyRunningThread->previousTCB = CurrentlyRunningThread;
+    SleepQueue = 0;
+    ArmWakeTimer();                 //Stops the wake timer
 
     EndCriticalSection(IBit_State);
 }
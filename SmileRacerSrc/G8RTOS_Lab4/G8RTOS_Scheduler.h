@@ -12,6 +12,9 @@
 #define MAXPTHREADS 6
 #define STACKSIZE 256
 #define OSINT_PRIORITY 7
+#define DEFAULT_QUANTUM 1
+#define EDF_PRIORITY 251
+#define DELAY_SLEEP_THRESHOLD_US 100
 /*********************************************** Sizes and Limits *********************************************************************/
 
 //typedef int32_t threadId_t;
@@ -36,7 +39,15 @@ typedef enum {
     THREAD_DOES_NOT_EXIST       = -4,
     CANNOT_KILL_LAST_THREAD     = -5,
     IRQn_INVALID                = -6,
-    HWI_PRIORITY_INVALID        = -7
+    HWI_PRIORITY_INVALID        = -7,
+    COOP_TASK_LIMIT_REACHED     = -8,
+    DEFERRED_LIMIT_REACHED      = -9,
+    POOL_INVALID                = -10,
+    HEALTH_LIMIT_REACHED        = -11,
+    PERIODIC_LIMIT_REACHED      = -12,
+    PERIODIC_OVERLOAD           = -13,
+    SEMAPHORE_STATS_LIMIT_REACHED = -14,
+    POOL_DOUBLE_FREE            = -15
 } sched_ErrCode_t;
 
 /*********************************************** Public Variables *********************************************************************/
@@ -75,9 +86,25 @@ sched_ErrCode_t G8RTOS_AddThread(void (*threadToAdd)(void), uint8_t priority, ch
  * The struct will be added to a linked list of periodic events
  * Param Pthread To Add: void-void function for P thread handler
  * Param period: period of P thread to add
- * Returns: Error code for adding threads
+ * Param execution: SystemTime of the first release
+ * Param budgetUs: worst-case execution time of the handler in us
+ * Returns: Error code for adding threads, PERIODIC_OVERLOAD if the events would fail the rate monotonic bound
+ */
+sched_ErrCode_t G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t period, uint32_t execution, uint32_t budgetUs);
+
+/*
+ * Copies the budget and measured execution of a periodic event
+ *  - maxCycles is the longest run seen, overruns counts runs longer than the budget
+ * Param "PthreadToFind": Handler the event was added with
+ * Param "stats": Copy of the periodic event control block
+ * Returns: Error code if no event has that handler
+ */
+sched_ErrCode_t G8RTOS_GetPeriodicStats(void (*PthreadToFind)(void), ptcb_t *stats);
+
+/*
+ * Returns the periodic events' share of the CPU in hundredths of a percent, from their budgets
  */
-int G8RTOS_AddPeriodicEvent(void (*PthreadToAdd)(void), uint32_t period, uint32_t execution);
+uint32_t G8RTOS_GetPeriodicUtilization(void);
 
 void G8RTOS_KillAllThreads();
 
@@ -90,14 +117,131 @@ sched_ErrCode_t G8RTOS_AddAPeriodicEvent(void (*AthreadToAdd)(void), uint8_t pri
  */
 void sleep(uint32_t durationMS);
 
+/*
+ * Puts the current thread into a sleep state with microsecond resolution
+ *  - The wake timer fires at the wake time instead of waiting for the next tick
+ *  - Durations up to 2^31 us (about 35 minutes), sleep() has the same limit
+ *  param durationUs: Duration of sleep time in us
+ */
+void G8RTOS_SleepUs(uint32_t durationUs);
+
+/*
+ * Returns true if the caller may make a blocking kernel call
+ *  - False from interrupts, inside a critical section and before G8RTOS_Launch
+ */
+bool G8RTOS_CanBlock(void);
+
+/*
+ * Waits at least "us" microseconds, the delay every driver should use
+ *  - Waits of DELAY_SLEEP_THRESHOLD_US or more from a thread sleep so other threads get the CPU
+ *  - Shorter waits, and any wait from an interrupt, a critical section or before launch, spin on the cycle counter
+ *  param us: Duration of the delay in us
+ */
+void G8RTOS_DelayUs(uint32_t us);
+
+/*
+ * Waits at least "ms" milliseconds, see G8RTOS_DelayUs
+ *  param ms: Duration of the delay in ms
+ */
+void G8RTOS_DelayMs(uint32_t ms);
+
+/*
+ * Inserts a thread into the sleep queue, kernel use only
+ *  - Caller must hold a critical section
+ * Param "thread": Thread to put to sleep
+ * Param "wakeTime": Time in us (G8RTOS_GetTimeUs) to wake the thread at
+ */
+void G8RTOS_SleepQueueInsert(tcb_t *thread, uint32_t wakeTime);
+
+/*
+ * Removes a thread from the sleep queue before its wake time, kernel use only
+ *  - Caller must hold a critical section
+ * Param "thread": Thread to take out of the queue
+ */
+void G8RTOS_SleepQueueRemove(tcb_t *thread);
+
+/*
+ * Checks if a ready thread should run before the running thread, kernel use only
+ *  - Lower priority number first, then the earlier deadline between EDF threads of the same priority
+ * Param "thread": Ready thread to compare
+ * Returns: true if the scheduler would switch to it
+ */
+bool G8RTOS_Preempts(tcb_t *thread);
+
+/*
+ * Tells the kernel the CPU clock changed, register it with the clock manager
+ *  - Keeps the 1 ms tick, the sleep queue, the watchdog and the profiler at the same real time
+ *  - Safe before launch, only the parts already running are touched
+ * Param "clockHz": New CPU clock in Hz, a whole number of MHz
+ */
+void G8RTOS_ClockChanged(uint32_t clockHz);
+
 threadId_t G8RTOS_GetThreadId();
 
 sched_ErrCode_t G8RTOS_KillThread(threadId_t threadID);
 
 sched_ErrCode_t G8RTOS_KillSelf();
 
+/*
+ * Gives up the rest of the quantum to another ready thread of equal or higher priority
+ */
+void G8RTOS_Yield(void);
+
 uint32_t GetNumberOfThreads(void);
 
+/*
+ * Changes the priority of a thread at runtime
+ * Param "threadID": ID of the thread to change
+ * Param "priority": New priority, 0 is the highest
+ * Returns: Error code if the thread does not exist
+ */
+sched_ErrCode_t G8RTOS_SetPriority(threadId_t threadID, uint8_t priority);
+
+/*
+ * Configures priority aging
+ *  - A thread ready for "thresholdMS" without running is raised "boost" levels until it runs
+ * Param "thresholdMS": Ready time before a boost, 0 disables aging
+ * Param "boost": Levels added per threshold crossed
+ */
+void G8RTOS_SetAging(uint32_t thresholdMS, uint8_t boost);
+
+/*
+ * Sets the time slice quantum
+ *  - Threads of equal priority round robin every "quantumMS" ticks
+ * Param "quantumMS": Ticks per quantum, at least 1
+ */
+void G8RTOS_SetQuantum(uint32_t quantumMS);
+
+/*
+ * Returns the number of times the scheduler has run since launch
+ */
+uint32_t G8RTOS_GetContextSwitchCount(void);
+
+/*
+ * Adds a periodic thread to the earliest-deadline-first band
+ *  - EDF threads all run at EDF_PRIORITY, among them the earliest absolute deadline goes first
+ *  - Fixed priority threads above EDF_PRIORITY preempt the band, ones below only run when it is idle
+ *  - The thread runs one job per loop and ends each with G8RTOS_WaitNextPeriod
+ * Param "threadToAdd": Void-Void Function to add
+ * Param "periodMS": Time between releases
+ * Param "deadlineMS": Time after a release the job must finish by, at most the period
+ * Returns: Error code for adding threads
+ */
+sched_ErrCode_t G8RTOS_AddEDFThread(void (*threadToAdd)(void), uint32_t periodMS, uint32_t deadlineMS, char *name);
+
+/*
+ * Ends the current job of an EDF thread and sleeps until its next release
+ *  - A job finishing after its deadline counts as a miss
+ *  - If the next release already passed the job is skipped to now, so an overrun never builds a backlog
+ */
+void G8RTOS_WaitNextPeriod(void);
+
+/*
+ * Copies the job and deadline miss counts of an EDF thread
+ * Returns: Error code if the thread does not exist
+ */
+sched_ErrCode_t G8RTOS_GetEDFStats(threadId_t threadID, uint32_t *jobs, uint32_t *deadlineMisses);
+
 /*********************************************** Public Functions *********************************************************************/
 
 #endif /* G8RTOS_SCHEDULER_H_ */
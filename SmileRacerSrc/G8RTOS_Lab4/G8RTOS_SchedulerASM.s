@@ -10,7 +10,7 @@
 
 	.thumb		; Set to thumb mode
 	.align 2	; Align by 2 bytes (thumb mode uses allignment by 2 or 4)
-	.text		; Text section
+	.sect ".ramfunc"	; Runs from SRAM, see G8RTOS_Sections.h
 
 ; Need to have the address defined in file 
 ; (label needs to be close enough to asm code to be reached with PC relative addressing)
@@ -18,16 +18,24 @@ RunningPtr: .field CurrentlyRunningThread, 32
 
 ; G8RTOS_Start
 ;	Sets the first thread to be the currently running thread
+;	Moves SP onto the first thread's stack, dropping its initial frame, so its stack guard covers it
 ;	Starts the currently running thread by setting Link Register to tcb's Program Counter
 G8RTOS_Start:
 
 	.asmfunc
 	
+	CPSID I				;No switch may save context while SP moves
+	
 	LDR R4, RunningPtr	;Loads the address of RunningPtr into R4
 	LDR R5, [R4]		;Loads the currently running pointer into R5
 	LDR R6, [R5]		;Loads the first thread's stack pointer into R6
 	LDR LR, [R6, #56]	;Loads LR with the first thread's PC
 	
+	ADD R6, R6, #64		;Skips the 16 word initial frame, the thread starts with an empty stack
+	MOV SP, R6			;Runs the first thread on its own stack
+	
+	CPSIE I
+	
 	BX LR				;Branches to the first thread
 	
 	.endasmfunc
@@ -0,0 +1,28 @@
+/**
+ * G8RTOS_Sections.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_SECTIONS_H_
+#define G8RTOS_SECTIONS_H_
+
+/*********************************************** Defines ******************************************************************************/
+
+/*
+ * Runs a function from SRAM instead of flash
+ *  - Placed in .ramfunc, ResetISR copies it from flash before _c_int00
+ *  - Keep it to hot paths, the code comes out of the same 32 KB as the thread stacks
+ *  - Asm functions use .sect ".ramfunc" instead
+ */
+#define RAMFUNC __attribute__((section(".ramfunc")))
+
+/*
+ * Keeps a variable out of C startup initialization
+ *  - Placed in .noinit, its contents survive a watchdog or software reset
+ *  - Holds garbage after power-on, the owner has to validate it
+ */
+#define NOINIT __attribute__((section(".noinit")))
+
+/*********************************************** Defines ******************************************************************************/
+
+#endif /* G8RTOS_SECTIONS_H_ */
@@ -0,0 +1,243 @@
+/**
+ * G8RTOS_SemaphoreStats.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "G8RTOS_SemaphoreStats.h"
+#include "G8RTOS_Scheduler.h"
+#include "G8RTOS_CriticalSection.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_Health.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+/* Semaphore Stats Blocks
+ *  - One per registered semaphore, in registration order
+ */
+static semStats_t semaphoreStats[MAX_SEMAPHORE_STATS];
+
+/*********************************************** Data Structures Used *****************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * Current Number of registered semaphores
+ */
+static uint32_t NumberOfSemaphoreStats;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Finds the stats block of a semaphore
+ * Returns: The block, 0 if the semaphore is not registered
+ */
+static semStats_t *FindStats(semaphore_t *s)
+{
+    for(uint32_t i = 0;i < NumberOfSemaphoreStats;i++)
+    {
+        if(semaphoreStats[i].sem == s)
+        {
+            return &semaphoreStats[i];
+        }
+    }
+    return 0;
+}
+
+/*
+ * Converts a cycle count to whole microseconds for the table
+ */
+static uint32_t CyclesToUs(uint64_t cycles)
+{
+    return (uint32_t)(cycles / G8RTOS_GetCyclesPerUs());
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts gathering contention stats for a semaphore
+ * Returns: Error code for registering
+ * THIS IS A CRITICAL SECTION
+ */
+sched_ErrCode_t G8RTOS_RegisterSemaphoreStats(semaphore_t *s, char *name)
+{
+    int32_t IBit_State = StartCriticalSection();
+    semStats_t *stats = FindStats(s);
+    if(stats == 0)
+    {
+        if(NumberOfSemaphoreStats >= MAX_SEMAPHORE_STATS)
+        {
+            EndCriticalSection(IBit_State);
+            return SEMAPHORE_STATS_LIMIT_REACHED;
+        }
+        stats = &semaphoreStats[NumberOfSemaphoreStats];
+        stats->sem = s;
+        stats->acquisitions = 0;
+        stats->contended = 0;
+        stats->totalBlockedCycles = 0;
+        stats->maxBlockedCycles = 0;
+        stats->holder = 0;
+        stats->holderID = 0;
+        NumberOfSemaphoreStats++;
+    }
+
+    uint8_t i = 0;
+    while(i < MAX_NAME_LENGTH && name[i] != 0)
+    {
+        stats->name[i] = name[i];
+        i++;
+    }
+    stats->name[i] = 0;
+    EndCriticalSection(IBit_State);
+    return NO_ERROR;
+}
+
+/*
+ * Copies the stats of a registered semaphore
+ * Returns: true if the semaphore is registered
+ */
+bool G8RTOS_GetSemaphoreStats(semaphore_t *s, semStats_t *stats)
+{
+    int32_t IBit_State = StartCriticalSection();
+    semStats_t *found = FindStats(s);
+    if(found != 0)
+    {
+        *stats = *found;
+    }
+    EndCriticalSection(IBit_State);
+    return (found != 0);
+}
+
+/*
+ * Prints a table of every registered semaphore, most total blocked time first
+ *  - Insertion sorts an index array, the table is at most MAX_SEMAPHORE_STATS long
+ *  - Copies one entry at a time while printing, this runs on a thread's stack
+ *  - The holder is printed by name while that thread is still alive
+ *  - Names are padded after the string as UARTprintf does for %16s
+ */
+void G8RTOS_DumpSemaphoreStats(void (*print)(const char *format, ...))
+{
+    uint8_t order[MAX_SEMAPHORE_STATS];
+
+    int32_t IBit_State = StartCriticalSection();
+    uint32_t count = NumberOfSemaphoreStats;
+    for(uint32_t i = 0;i < count;i++)
+    {
+        uint32_t j = i;
+        while(j > 0 && semaphoreStats[order[j - 1]].totalBlockedCycles < semaphoreStats[i].totalBlockedCycles)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    EndCriticalSection(IBit_State);
+
+    print("semaphore        acquired  contended  blocked us   max us  holder\n");
+    for(uint32_t i = 0;i < count;i++)
+    {
+        semStats_t entry;
+        char holderName[MAX_NAME_LENGTH + 1];
+
+        IBit_State = StartCriticalSection();
+        entry = semaphoreStats[order[i]];
+        bool held = (entry.holder != 0 && entry.holder->isAlive && entry.holder->ThreadID == entry.holderID);
+        uint8_t c = 0;
+        while(held && c < MAX_NAME_LENGTH && entry.holder->Threadname[c] != 0)
+        {
+            holderName[c] = entry.holder->Threadname[c];
+            c++;
+        }
+        EndCriticalSection(IBit_State);
+        if(!held)
+        {
+            holderName[c++] = '-';
+        }
+        holderName[c] = 0;
+
+        print("%16s %8u %10u %11u %8u  %s\n",
+              entry.name,
+              entry.acquisitions,
+              entry.contended,
+              CyclesToUs(entry.totalBlockedCycles),
+              CyclesToUs(entry.maxBlockedCycles),
+              holderName);
+        G8RTOS_CheckIn();
+    }
+}
+
+/*
+ * A thread got the semaphore without blocking
+ */
+void G8RTOS_SemaphoreClaimed(semaphore_t *s, tcb_t *thread)
+{
+    semStats_t *stats = FindStats(s);
+    if(stats != 0)
+    {
+        stats->acquisitions++;
+        stats->holder = thread;
+        stats->holderID = thread->ThreadID;
+    }
+}
+
+/*
+ * The current thread is about to block on the semaphore
+ *  - Stamps the thread so the wake can measure how long it waited
+ */
+void G8RTOS_SemaphoreBlocked(semaphore_t *s, tcb_t *thread)
+{
+    semStats_t *stats = FindStats(s);
+    if(stats != 0)
+    {
+        stats->contended++;
+        thread->blockedSince = G8RTOS_GetCycleCount();
+    }
+}
+
+/*
+ * A blocked thread is handed the semaphore by a signal
+ */
+void G8RTOS_SemaphoreWoken(semaphore_t *s, tcb_t *thread)
+{
+    semStats_t *stats = FindStats(s);
+    if(stats != 0)
+    {
+        uint32_t blocked = G8RTOS_GetCycleCount() - thread->blockedSince;
+        stats->totalBlockedCycles += blocked;
+        if(blocked > stats->maxBlockedCycles)
+        {
+            stats->maxBlockedCycles = blocked;
+        }
+        stats->acquisitions++;
+        stats->holder = thread;
+        stats->holderID = thread->ThreadID;
+    }
+}
+
+/*
+ * The semaphore was signalled with no thread waiting
+ */
+void G8RTOS_SemaphoreReleased(semaphore_t *s)
+{
+    semStats_t *stats = FindStats(s);
+    if(stats != 0)
+    {
+        stats->holder = 0;
+        stats->holderID = 0;
+    }
+}
+
+/*********************************************** Public Functions *********************************************************************/
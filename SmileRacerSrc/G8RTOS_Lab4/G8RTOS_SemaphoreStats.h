@@ -0,0 +1,60 @@
+/**
+ * G8RTOS_SemaphoreStats.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_SEMAPHORESTATS_H_
+#define G8RTOS_SEMAPHORESTATS_H_
+
+#include <stdint.h>
+#include "G8RTOS_Structures.h"
+#include "G8RTOS_Scheduler.h"
+
+/*********************************************** Sizes and Limits *********************************************************************/
+#define MAX_SEMAPHORE_STATS 8
+/*********************************************** Sizes and Limits *********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts gathering contention stats for a semaphore
+ *  - Only registered semaphores are tracked, the rest pay for one empty lookup
+ *  - Registering the same semaphore again just renames it
+ * Param "s": Pointer to semaphore or mutex to track
+ * Param "name": Name shown in the table, cut to MAX_NAME_LENGTH characters
+ * Returns: Error code for registering
+ */
+sched_ErrCode_t G8RTOS_RegisterSemaphoreStats(semaphore_t *s, char *name);
+
+/*
+ * Copies the stats of a registered semaphore
+ * Param "s": Pointer to semaphore the stats were registered for
+ * Param "stats": Copy of the stats block
+ * Returns: true if the semaphore is registered
+ */
+bool G8RTOS_GetSemaphoreStats(semaphore_t *s, semStats_t *stats);
+
+/*
+ * Prints a table of every registered semaphore, most total blocked time first
+ *  - Sorts under a critical section, then copies and prints one entry at a time
+ * Param "print": printf-style output function, e.g. UARTprintf
+ */
+void G8RTOS_DumpSemaphoreStats(void (*print)(const char *format, ...));
+
+/*
+ * Hooks called by the semaphore code, kernel use only
+ *  - Caller must hold a critical section
+ *  - Claimed: "thread" got the semaphore without blocking
+ *  - Blocked: the current thread is about to block on it
+ *  - Woken: "thread" was blocked and is handed the semaphore by a signal
+ *  - Released: signalled with no thread waiting
+ */
+void G8RTOS_SemaphoreClaimed(semaphore_t *s, tcb_t *thread);
+void G8RTOS_SemaphoreBlocked(semaphore_t *s, tcb_t *thread);
+void G8RTOS_SemaphoreWoken(semaphore_t *s, tcb_t *thread);
+void G8RTOS_SemaphoreReleased(semaphore_t *s);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_SEMAPHORESTATS_H_ */
@@ -6,17 +6,79 @@
 /*********************************************** Dependencies and Externs *************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "inc/hw_types.h"
 #include "inc/hw_ints.h"
 #include "inc/hw_nvic.h"
 #include "G8RTOS_Semaphores.h"
 #include "G8RTOS_CriticalSection.h"
 #include "G8RTOS_Scheduler.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_SVC.h"
+#include "G8RTOS_SemaphoreStats.h"
 
 
 /*********************************************** Dependencies and Externs *************************************************************/
 
 
+/*********************************************** Private Functions ********************************************************************/
+
+/*
+ * Unblocks the first thread waiting on a semaphore or condition
+ *  - Takes the thread out of the sleep queue if it was a timed wait
+ *  - Starts a context switch if the unblocked thread has a higher priority or an earlier EDF deadline
+ *  - Hands the stats of a registered semaphore to the woken thread, or marks it released
+ *  - Caller must hold a critical section
+ * Param "s": Pointer to semaphore or condition the thread is blocked on
+ */
+static void UnblockOneThread(semaphore_t *s)
+{
+    tcb_t* thr = CurrentlyRunningThread->nextTCB;
+    // find a thread that is waiting on this semaphore
+    while(thr != CurrentlyRunningThread)
+    {
+        if (thr->blocked == s)
+        {
+            thr->blocked = UNBLOCKED;
+            G8RTOS_SemaphoreWoken(s, thr);
+            // a timed wait is also in the sleep queue
+            if (thr->asleep)
+            {
+                G8RTOS_SleepQueueRemove(thr);
+            }
+            // preempt right away if the woken thread outranks us or is an EDF peer due sooner,
+            // the tick no longer reschedules every time
+            if (G8RTOS_Preempts(thr))
+            {
+                HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+            }
+            return; // only do it once!
+        }
+        thr = thr->nextTCB;
+    }
+    G8RTOS_SemaphoreReleased(s);
+}
+
+/*
+ * Blocks the current thread on a semaphore or condition it already took a count from
+ *  - A timeout also puts it in the sleep queue, the wake timer gives the count back if it expires
+ *  - Caller must hold a critical section and pend the context switch after ending it
+ * Param "s": Pointer to semaphore or condition to block on
+ * Param "timeoutMS": Time to wait, WAIT_FOREVER to only wake on a signal
+ */
+static void BlockCurrentThread(semaphore_t *s, uint32_t timeoutMS)
+{
+    CurrentlyRunningThread->blocked = s;
+    CurrentlyRunningThread->timedOut = false;
+    if (timeoutMS != WAIT_FOREVER)
+    {
+        G8RTOS_SleepQueueInsert(CurrentlyRunningThread, (uint32_t)G8RTOS_GetTimeUs() + timeoutMS * 1000);
+    }
+}
+
+/*********************************************** Private Functions ********************************************************************/
+
+
 /*********************************************** Public Functions *********************************************************************/
 
 /*
@@ -36,37 +98,19 @@ void G8RTOS_InitSemaphore(semaphore_t *s, int32_t value)
  * No longer waits for semaphore
  *  - Decrements semaphore
  *  - Blocks thread if sempahore is unavailable
+ *  - Enters the kernel through SVC so blocking and the context switch are one exception
  * Param "s": Pointer to semaphore to wait on
- * THIS IS A CRITICAL SECTION
  */
 void G8RTOS_WaitSemaphore(semaphore_t *s)
 {
-    // Strategy: begin and end critical section when dealing with semaphores
-    // Turn off interrupts when dealing with I2C. This is a separate issue.
-    IBit_State = StartCriticalSection();
-    // Try to claim the semaphore.
-    *(s) -= 1;
-    if (*(s) >= 0) // successfully claimed!
-    {
-        EndCriticalSection(IBit_State);
-        return;
-    }
-    else  // semaphore is negative
-    {
-        //currently running thread gets blocked.
-        CurrentlyRunningThread->blocked = s;
-        // Yield the CPU
-        EndCriticalSection(IBit_State);
-        //trigger scheduler switch
-        HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
-        return;
-    }
+    G8RTOS_SVCWait(s, WAIT_FOREVER);
 }
 
 /*
  * Signals the completion of the usage of a semaphore
  *  - Increments the semaphore value by 1
  *  - Unblocks any threads waiting on that semaphore
+ *  - Starts a context switch if the unblocked thread has a higher priority
  * Param "s": Pointer to semaphore to be signaled
  * THIS IS A CRITICAL SECTION
  */
@@ -76,20 +120,172 @@ void G8RTOS_SignalSemaphore(semaphore_t *s)
     // give back the semaphore
     *(s) += 1;
     // unblock one semaphore
-    tcb_t* thr = CurrentlyRunningThread->nextTCB;
-    // find a thread that is waiting on this semaphore
-    while(thr != CurrentlyRunningThread)
+    UnblockOneThread(s);
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Waits for a semaphore with a timeout
+ *  - Decrements semaphore
+ *  - Blocks thread if semaphore is unavailable, until signaled or the timeout expires
+ *  - The timeout sits in the sleep queue, so it costs nothing until it expires
+ * Param "s": Pointer to semaphore to wait on
+ * Param "timeoutMS": Time to wait, 0 never blocks, WAIT_FOREVER is G8RTOS_WaitSemaphore
+ * Returns: true if the semaphore was claimed, false on timeout
+ */
+bool G8RTOS_WaitSemaphoreTimeout(semaphore_t *s, uint32_t timeoutMS)
+{
+    if (timeoutMS == 0) // never blocks, no need to enter the kernel
     {
-        if (thr->blocked == s)
-        {
-            thr->blocked = UNBLOCKED;
-            break; // only do it once!
-        }
-        thr = thr->nextTCB;
+        return G8RTOS_KernelWait(s, 0);
+    }
+    // runs again once claimed, signaled or timed out
+    return G8RTOS_SVCWait(s, timeoutMS) && !CurrentlyRunningThread->timedOut;
+}
+
+/*
+ * Claims a semaphore only if it is available
+ * Param "s": Pointer to semaphore to claim
+ * Returns: true if the semaphore was claimed
+ * THIS IS A CRITICAL SECTION
+ */
+bool G8RTOS_TryWait(semaphore_t *s)
+{
+    return G8RTOS_WaitSemaphoreTimeout(s, 0);
+}
+
+/*
+ * Initializes a condition variable with no waiters
+ * Param "c": Pointer to condition
+ */
+void G8RTOS_InitCondition(condition_t *c)
+{
+    int32_t IBit_State = StartCriticalSection();
+    *(c) = 0;
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Waits on a condition with a timeout
+ *  - Releases the mutex and blocks in one critical section so no signal is missed
+ *  - Claims the mutex again before returning, also on timeout
+ * Param "c": Pointer to condition to wait on
+ * Param "mutex": Pointer to the mutex guarding the condition, must be held by the caller
+ * Param "timeoutMS": Time to wait, WAIT_FOREVER to only wake on a signal
+ * Returns: true if signaled, false on timeout
+ */
+bool G8RTOS_WaitConditionTimeout(condition_t *c, semaphore_t *mutex, uint32_t timeoutMS)
+{
+    G8RTOS_SVCWaitCondition(c, mutex, timeoutMS);
+
+    bool signaled = !CurrentlyRunningThread->timedOut;
+    G8RTOS_WaitSemaphore(mutex);
+    return signaled;
+}
+
+/*
+ * Waits on a condition
+ * Param "c": Pointer to condition to wait on
+ * Param "mutex": Pointer to the mutex guarding the condition, must be held by the caller
+ */
+void G8RTOS_WaitCondition(condition_t *c, semaphore_t *mutex)
+{
+    G8RTOS_WaitConditionTimeout(c, mutex, WAIT_FOREVER);
+}
+
+/*
+ * Wakes one thread waiting on a condition, does nothing if there are none
+ * Param "c": Pointer to condition to signal
+ * THIS IS A CRITICAL SECTION
+ */
+void G8RTOS_SignalCondition(condition_t *c)
+{
+    int32_t IBit_State = StartCriticalSection();
+    if (*(c) < 0)
+    {
+        *(c) += 1;
+        UnblockOneThread(c);
     }
     EndCriticalSection(IBit_State);
 }
 
+/*
+ * Wakes every thread waiting on a condition
+ * Param "c": Pointer to condition to broadcast
+ * THIS IS A CRITICAL SECTION
+ */
+void G8RTOS_BroadcastCondition(condition_t *c)
+{
+    int32_t IBit_State = StartCriticalSection();
+    while (*(c) < 0)
+    {
+        *(c) += 1;
+        UnblockOneThread(c);
+    }
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Kernel side of G8RTOS_WaitSemaphore and G8RTOS_WaitSemaphoreTimeout
+ *  - Claims the semaphore or blocks the current thread on it
+ *  - Pends the context switch, from the SVC it tail-chains into PendSV
+ * Param "s": Pointer to semaphore to wait on
+ * Param "timeoutMS": Time to wait, 0 never blocks, WAIT_FOREVER to only wake on a signal
+ * Returns: false only if the semaphore was unavailable and the thread could not block
+ * THIS IS A CRITICAL SECTION
+ */
+bool G8RTOS_KernelWait(semaphore_t *s, uint32_t timeoutMS)
+{
+    int32_t IBit_State = StartCriticalSection();
+    CurrentlyRunningThread->timedOut = false;
+    // Try to claim the semaphore.
+    *(s) -= 1;
+    if (*(s) >= 0) // successfully claimed!
+    {
+        G8RTOS_SemaphoreClaimed(s, CurrentlyRunningThread);
+        EndCriticalSection(IBit_State);
+        return true;
+    }
+    if (timeoutMS == 0) // not allowed to block, give it back
+    {
+        *(s) += 1;
+        EndCriticalSection(IBit_State);
+        return false;
+    }
+
+    //currently running thread gets blocked.
+    G8RTOS_SemaphoreBlocked(s, CurrentlyRunningThread);
+    BlockCurrentThread(s, timeoutMS);
+    EndCriticalSection(IBit_State);
+    //trigger scheduler switch
+    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+    return true;
+}
+
+/*
+ * Kernel side of G8RTOS_WaitConditionTimeout
+ *  - Releases the mutex and blocks in one critical section so no signal is missed
+ * Param "c": Pointer to condition to wait on
+ * Param "mutex": Pointer to the mutex guarding the condition
+ * Param "timeoutMS": Time to wait, WAIT_FOREVER to only wake on a signal
+ * Returns: true, the outcome is in timedOut once the thread runs again
+ * THIS IS A CRITICAL SECTION
+ */
+bool G8RTOS_KernelWaitCondition(condition_t *c, semaphore_t *mutex, uint32_t timeoutMS)
+{
+    int32_t IBit_State = StartCriticalSection();
+    // count ourselves as a waiter
+    *(c) -= 1;
+    // release the mutex
+    *(mutex) += 1;
+    UnblockOneThread(mutex);
+
+    BlockCurrentThread(c, timeoutMS);
+    EndCriticalSection(IBit_State);
+    HWREG(NVIC_INT_CTRL) |= NVIC_INT_CTRL_PEND_SV;
+    return true;
+}
+
 void G8RTOS_Decrement(semaphore_t *s)
 {
     IBit_State = StartCriticalSection();
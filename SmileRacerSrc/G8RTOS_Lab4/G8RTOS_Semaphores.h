@@ -6,6 +6,7 @@
 #define G8RTOS_SEMAPHORES_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /*********************************************** Datatype Definitions *****************************************************************/
 
@@ -14,6 +15,17 @@
  */
 typedef int32_t semaphore_t;
 
+/*
+ * Condition variable typedef
+ *  - Holds minus the number of waiting threads
+ */
+typedef int32_t condition_t;
+
+/*
+ * Timeout that never expires
+ */
+#define WAIT_FOREVER 0xFFFFFFFF
+
 int32_t IBit_State;
 
 /*********************************************** Datatype Definitions *****************************************************************/
@@ -45,6 +57,57 @@ void G8RTOS_SignalSemaphore(semaphore_t *s);
 
 void G8RTOS_Decrement(semaphore_t *s);
 
+/*
+ * Waits for a semaphore with a timeout
+ *  - Blocks until signaled or the timeout expires, the timeout lives in the sleep queue
+ * Param "s": Pointer to semaphore to wait on
+ * Param "timeoutMS": Time to wait, 0 never blocks, WAIT_FOREVER never times out
+ * Returns: true if the semaphore was claimed, false on timeout
+ */
+bool G8RTOS_WaitSemaphoreTimeout(semaphore_t *s, uint32_t timeoutMS);
+
+/*
+ * Claims a semaphore only if it is available, never blocks
+ * Param "s": Pointer to semaphore to claim
+ * Returns: true if the semaphore was claimed
+ */
+bool G8RTOS_TryWait(semaphore_t *s);
+
+/*
+ * Initializes a condition variable with no waiters
+ * Param "c": Pointer to condition
+ */
+void G8RTOS_InitCondition(condition_t *c);
+
+/*
+ * Waits on a condition
+ *  - Atomically releases the mutex and blocks, claims the mutex again before returning
+ * Param "c": Pointer to condition to wait on
+ * Param "mutex": Pointer to the mutex guarding the condition, must be held by the caller
+ */
+void G8RTOS_WaitCondition(condition_t *c, semaphore_t *mutex);
+
+/*
+ * Waits on a condition with a timeout
+ * Param "c": Pointer to condition to wait on
+ * Param "mutex": Pointer to the mutex guarding the condition, must be held by the caller
+ * Param "timeoutMS": Time to wait, WAIT_FOREVER never times out
+ * Returns: true if signaled, false on timeout
+ */
+bool G8RTOS_WaitConditionTimeout(condition_t *c, semaphore_t *mutex, uint32_t timeoutMS);
+
+/*
+ * Wakes one thread waiting on a condition
+ * Param "c": Pointer to condition to signal
+ */
+void G8RTOS_SignalCondition(condition_t *c);
+
+/*
+ * Wakes every thread waiting on a condition
+ * Param "c": Pointer to condition to broadcast
+ */
+void G8RTOS_BroadcastCondition(condition_t *c);
+
 /*********************************************** Public Functions *********************************************************************/
 
 
@@ -31,9 +31,21 @@ typedef struct tcb_t {          //TBC structure declaration
     struct tcb_t *nextTCB;
     struct tcb_t *previousTCB;
     semaphore_t *blocked;
-    uint32_t sleepCount;
+    uint32_t sleepCount;        //Wake time in us while asleep
     bool asleep;
+    bool timedOut;
+    struct tcb_t *nextSleeping;
     uint8_t priority;
+    uint8_t basePriority;
+    uint32_t readySince;
+    bool isEDF;
+    uint32_t period;
+    uint32_t relativeDeadline;
+    uint32_t release;
+    uint32_t deadline;
+    uint32_t jobs;
+    uint32_t deadlineMisses;
+    uint32_t blockedSince;      //Cycle count when it last blocked on a semaphore with stats
     bool isAlive;
     char Threadname[MAX_NAME_LENGTH];
     threadId_t ThreadID;
@@ -44,6 +56,7 @@ typedef struct tcb_t {          //TBC structure declaration
  *      - Holds a function pointer that points to the periodic thread to be executed
  *      - Has a period in us
  *      - Holds Current time
+ *      - Holds its worst-case execution budget and the longest run measured, in cycles
  *      - Contains pointer to the next periodic event - linked list
  */
 
@@ -53,10 +66,154 @@ typedef struct ptcb_t {         //TCBP structure
     uint32_t period;
     uint32_t executeTime;
     uint32_t currentTime;
+    uint32_t budgetUs;
+    uint32_t maxCycles;
+    uint32_t overruns;
     struct ptcb_t *previousPTCB;
     struct ptcb_t *nextPTCB;
 } ptcb_t;
 
+/*
+ *  Deferred Event Control Block:
+ *      - Holds the top half run at interrupt level and the bottom half run by the deferred worker thread
+ *      - Pending bottom halves are linked into the work queue, a second post while pending is coalesced
+ *      - Holds latency stats for the IRQ, all times are in CPU cycles
+ */
+typedef struct dpcb_t {
+    void (*topHalf)(void);
+    void (*bottomHalf)(void);
+    int32_t IRQn;
+    bool pending;
+    uint32_t postTime;
+    uint32_t count;
+    uint32_t coalesced;
+    uint32_t maxTopHalfCycles;
+    uint32_t maxLatencyCycles;
+    uint32_t totalLatencyCycles;
+    struct dpcb_t *nextPending;
+} dpcb_t;
+
+/*
+ *  Cooperative Task Control Block:
+ *      - Stackless run-to-completion task multiplexed inside the cooperative host thread
+ *      - Holds the line continuation the handler resumes from and the system time it is next due
+ *      - Holds a few words of private state in place of a thread stack
+ */
+
+#define COOP_STATE_WORDS 6
+
+typedef struct ctcb_t {
+    int32_t (*handler)(struct ctcb_t *task);
+    uint16_t lineContinuation;
+    bool isAlive;
+    uint32_t wakeTime;
+    struct ctcb_t *nextTask;
+    uint32_t state[COOP_STATE_WORDS];
+} ctcb_t;
+
+/*
+ *  Stack Fault Record:
+ *      - Filled by the MemManage handler when a thread runs into its stack guard
+ *      - Holds the thread that overflowed and the address it faulted on
+ */
+typedef struct fault_t {
+    threadId_t ThreadID;
+    char Threadname[MAX_NAME_LENGTH + 1];
+    uint32_t faultAddress;
+    uint32_t faultStatus;
+} fault_t;
+
+/*
+ *  Health Control Block:
+ *      - One per thread registered with the health monitor
+ *      - Holds the longest the thread may go between check-ins and when it last checked in
+ */
+typedef struct hcb_t {
+    tcb_t *thread;
+    threadId_t ThreadID;
+    uint32_t period;
+    uint32_t lastCheckIn;
+} hcb_t;
+
+/*
+ *  Reset Record:
+ *      - Written by the health monitor when a thread misses its check-in, then the watchdog resets the board
+ *      - Lives in .noinit so it is still there after the reset, cleared on power-on
+ */
+typedef struct resetRecord_t {
+    uint32_t valid;
+    threadId_t ThreadID;
+    char Threadname[MAX_NAME_LENGTH + 1];
+    uint32_t missedAt;
+    uint32_t lateBy;
+    uint32_t watchdogResets;
+} resetRecord_t;
+
+/*
+ *  Fixed-Block Pool:
+ *      - Carves caller provided storage into equal blocks, free blocks are linked through their first word
+ *      - Allocating and freeing pop and push the head of the free list
+ *      - One bit per block marks it allocated, catches double frees
+ *      - Holds usage stats so the pool can be sized by workload
+ */
+typedef struct pool_t {
+    void *freeList;
+    uint8_t *storage;
+    uint32_t *inUseMap;
+    uint32_t blockSize;
+    uint32_t numBlocks;
+    uint32_t inUse;
+    uint32_t peakInUse;
+    uint32_t allocations;
+    uint32_t failedAllocations;
+} pool_t;
+
+/*
+ *  Semaphore Stats Block:
+ *      - One per semaphore registered for contention stats, looked up by the semaphore's address
+ *      - Blocked times are in CPU cycles, from the wait that blocked to the signal that handed the semaphore over
+ *      - The holder is the thread that last claimed the semaphore, 0 once it is signalled with no waiter
+ */
+typedef struct semStats_t {
+    semaphore_t *sem;
+    char name[MAX_NAME_LENGTH + 1];
+    uint32_t acquisitions;
+    uint32_t contended;
+    uint64_t totalBlockedCycles;
+    uint32_t maxBlockedCycles;
+    struct tcb_t *holder;
+    threadId_t holderID;
+} semStats_t;
+
+/*
+ *  Profiler Sample:
+ *      - One PC sampler interrupt, the PC it interrupted and the thread that was running
+ *      - ThreadID is PROFILER_ISR_ID when the sampler interrupted another handler
+ */
+typedef struct pcSample_t {
+    uint32_t pc;
+    threadId_t ThreadID;
+} pcSample_t;
+
+/*
+ *  Profile Site:
+ *      - One per PROFILE_SCOPE, a static the macro declares where the scope is written
+ *      - Linked into the site list the first time the scope finishes
+ *      - Times are in CPU cycles, histogram bucket n counts runs of 2^n to 2^(n+1) - 1 cycles, the last bucket is open
+ */
+#define PROFILE_HISTOGRAM_BUCKETS 24
+
+typedef struct profileSite_t {
+    const char *name;
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t sumCycles;
+    uint32_t histogram[PROFILE_HISTOGRAM_BUCKETS];
+    bool registered;
+    struct profileSite_t *nextSite;
+} profileSite_t;
+
 /*********************************************** Data Structure Definitions ***********************************************************/
 
 
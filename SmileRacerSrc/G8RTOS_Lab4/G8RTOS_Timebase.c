@@ -0,0 +1,141 @@
+/**
+ * G8RTOS_Timebase.c
+ * uP2 - Fall 2022
+ */
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "G8RTOS_Timebase.h"
+#include "G8RTOS_CriticalSection.h"
+
+/*********************************************** Dependencies and Externs *************************************************************/
+
+
+/*********************************************** Defines ******************************************************************************/
+
+/* Debug Exception and Monitor Control, TRCENA powers the DWT */
+#define DEMCR               0xE000EDFC
+#define DEMCR_TRCENA        0x01000000
+
+/* DWT Control, CYCCNTENA starts the cycle counter */
+#define DWT_CTRL            0xE0001000
+#define DWT_CTRL_CYCCNTENA  0x00000001
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Private Variables ********************************************************************/
+
+/*
+ * 64-bit extension of the cycle counter: the last raw reading and the wraps seen so far
+ */
+static uint32_t LastCycleCount;
+static uint32_t CycleWraps;
+
+/*
+ * CPU cycles per microsecond at the current clock
+ */
+static uint32_t CyclesPerUs;
+
+/*
+ * Cycle count and time at the last clock change, GetTimeUs counts from here
+ */
+static uint64_t EpochCycles;
+static uint64_t EpochUs;
+
+/*********************************************** Private Variables ********************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the DWT cycle counter and the 64-bit extension
+ *  - Takes the current clock as the starting rate
+ */
+void G8RTOS_InitTimebase(void)
+{
+    HWREG(DEMCR) |= DEMCR_TRCENA;
+    DWT_CYCCNT_R = 0;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+
+    LastCycleCount = 0;
+    CycleWraps = 0;
+    EpochCycles = 0;
+    EpochUs = 0;
+    CyclesPerUs = SysCtlClockGet() / 1000000;
+}
+
+/*
+ * Tells the timebase the CPU clock changed
+ *  - Moves the epoch to now so elapsed time keeps its old rate
+ */
+void G8RTOS_SetTimebaseClock(uint32_t clockHz)
+{
+    int32_t IBit_State = StartCriticalSection();
+    uint64_t now = G8RTOS_GetCycles();
+    EpochUs += (now - EpochCycles) / CyclesPerUs;
+    EpochCycles = now;
+    CyclesPerUs = clockHz / 1000000;
+    EndCriticalSection(IBit_State);
+}
+
+/*
+ * Returns the raw 32-bit cycle count
+ */
+uint32_t G8RTOS_GetCycleCount(void)
+{
+    return DWT_CYCCNT_R;
+}
+
+/*
+ * Returns CPU cycles since G8RTOS_Init as a 64-bit count
+ *  - Counts a wrap whenever the raw count went backwards since the last call
+ */
+uint64_t G8RTOS_GetCycles(void)
+{
+    int32_t IBit_State = StartCriticalSection();
+    uint32_t now = DWT_CYCCNT_R;
+    if(now < LastCycleCount)
+    {
+        CycleWraps++;
+    }
+    LastCycleCount = now;
+    uint64_t cycles = ((uint64_t)CycleWraps << 32) | now;
+    EndCriticalSection(IBit_State);
+    return cycles;
+}
+
+/*
+ * Returns microseconds since G8RTOS_Init
+ */
+uint64_t G8RTOS_GetTimeUs(void)
+{
+    int32_t IBit_State = StartCriticalSection();
+    uint64_t us = EpochUs + (G8RTOS_GetCycles() - EpochCycles) / CyclesPerUs;
+    EndCriticalSection(IBit_State);
+    return us;
+}
+
+/*
+ * Returns CPU cycles per microsecond at the current clock
+ */
+uint32_t G8RTOS_GetCyclesPerUs(void)
+{
+    return CyclesPerUs;
+}
+
+/*
+ * Busy-waits at least "us" microseconds on the cycle counter
+ *  - Compares elapsed cycles, so it is wrap safe
+ */
+void G8RTOS_SpinUs(uint32_t us)
+{
+    uint32_t start = DWT_CYCCNT_R;
+    uint32_t cycles = us * CyclesPerUs;
+    while((DWT_CYCCNT_R - start) < cycles);
+}
+
+/*********************************************** Public Functions *********************************************************************/
@@ -0,0 +1,73 @@
+/**
+ * G8RTOS_Timebase.h
+ * uP2 - Fall 2022
+ */
+
+#ifndef G8RTOS_TIMEBASE_H_
+#define G8RTOS_TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************************************** Defines ******************************************************************************/
+
+/* DWT cycle counter, free running at the CPU clock once the timebase is initialized */
+#define DWT_CYCCNT_R    (*((volatile uint32_t *)0xE0001004))
+
+/*
+ * Wrap-safe comparison of two 32-bit times (SystemTime, cycle counts, deadlines)
+ *  - True when "a" is at or after "b", valid while they are less than half the range apart
+ */
+#define G8RTOS_TIME_AFTER_EQ(a, b)  ((int32_t)((uint32_t)(a) - (uint32_t)(b)) >= 0)
+#define G8RTOS_TIME_BEFORE(a, b)    ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+
+/*********************************************** Defines ******************************************************************************/
+
+
+/*********************************************** Public Functions *********************************************************************/
+
+/*
+ * Starts the DWT cycle counter and the 64-bit extension
+ *  - Called by G8RTOS_Init
+ */
+void G8RTOS_InitTimebase(void);
+
+/*
+ * Tells the timebase the CPU clock changed
+ *  - Time already elapsed is kept, only new cycles are converted at the new rate
+ * Param "clockHz": New CPU clock in Hz, a whole number of MHz
+ */
+void G8RTOS_SetTimebaseClock(uint32_t clockHz);
+
+/*
+ * Returns the raw 32-bit cycle count, cheap enough for ISRs and short intervals
+ *  - Wraps every 2^32 cycles (86 s at 50 MHz), take differences of two readings
+ */
+uint32_t G8RTOS_GetCycleCount(void);
+
+/*
+ * Returns CPU cycles since G8RTOS_Init as a 64-bit count that does not wrap
+ *  - Must be called at least once per 2^32 cycles, the Systick handler does this
+ */
+uint64_t G8RTOS_GetCycles(void);
+
+/*
+ * Returns microseconds since G8RTOS_Init, monotonic across clock changes
+ */
+uint64_t G8RTOS_GetTimeUs(void);
+
+/*
+ * Returns CPU cycles per microsecond at the current clock
+ */
+uint32_t G8RTOS_GetCyclesPerUs(void);
+
+/*
+ * Busy-waits at least "us" microseconds on the cycle counter
+ *  - Exact at any clock, safe from interrupts and critical sections
+ *  - For short hardware waits, G8RTOS_DelayUs sleeps instead once the wait is long enough
+ */
+void G8RTOS_SpinUs(uint32_t us);
+
+/*********************************************** Public Functions *********************************************************************/
+
+#endif /* G8RTOS_TIMEBASE_H_ */
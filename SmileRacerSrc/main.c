@@ -14,23 +14,57 @@
 #include "driverlib/sysctl.h"
 #include "BoardInitialization.h"
 #include "ILI9341_Lib.h"
+#include "utils/uartstdio.h"
 
 void main(void)
 {
     IntMasterDisable();
     G8RTOS_Init();
-    InitializeBoard();
-    LCD_Init(false);
+    InitializeBoard();          // also brings up the LCD
+#if PROFILE_SCOPES
+    uint64_t clearStart = G8RTOS_GetTimeUs();
+#endif
     LCD_Clear(LCD_BLACK);
+#if PROFILE_SCOPES
+    uint64_t firstFrame = G8RTOS_GetTimeUs();
+    UARTprintf("first frame at %u us, clear took %u us\n",        // profiling builds only
+               (uint32_t)firstFrame, (uint32_t)(firstFrame - clearStart));
+#endif
+
+    // Last reset was the watchdog, say which thread hung
+    if (G8RTOS_StartHealthMonitor() != NO_ERROR)
+    {
+        UARTprintf("health monitor not started, watchdog off\n");
+    }
+    resetRecord_t *lastReset = G8RTOS_GetResetRecord();
+    if (lastReset != 0)
+    {
+        LCD_TextBg(0, 0, (uint8_t*)"Watchdog reset:", LCD_RED, LCD_BLACK);
+        LCD_TextBg(128, 0, (uint8_t*)lastReset->Threadname, LCD_RED, LCD_BLACK);
+        G8RTOS_ClearResetRecord();
+    }
 
     seedRandom();
 
     G8RTOS_InitSemaphore(&LCD_mutex, 1);
     G8RTOS_InitSemaphore(&tap_flag, 0);
 
+    // Contention stats, dumped to the console at every game over
+    G8RTOS_RegisterSemaphoreStats(&LCD_mutex, "LCD_mutex");
+    G8RTOS_RegisterSemaphoreStats(&tap_flag, "tap_flag");
+    G8RTOS_RegisterSemaphoreStats(&game_over_sem, "game_over_sem");
+    G8RTOS_RegisterSemaphoreStats(&ball_ready, "ball_ready");
+
     G8RTOS_AddThread(background0, 255, "t0");
     G8RTOS_AddThread(game_over, 250, "t2"); // high priority
     G8RTOS_AddThread(wait_for_tap, 249, "t2"); // high priority
+    G8RTOS_AddThread(G8RTOS_CoopHost, 252, "coop"); // walls
+
+    G8RTOS_AddDeferredEvent(UART_int_handler, UART_rx_bottom_half, 1, INT_UART1);
+    LCD_InitDMA();          // lane fills go out over uDMA
+
+    G8RTOS_SetAging(100, 2);    // keeps print_score from starving behind the walls
+    G8RTOS_SetFaultHook(stack_fault_hook);
 
     //G8RTOS_InitFIFO(0);     // Fifo controller input. Used for debugging.
 
@@ -10,6 +10,7 @@
 #include "BoardSupport/inc/opt3001.h"
 #include "BoardSupport/inc/bme280.h"
 #include "BoardSupport/inc/Joystick.h"
+#include "BoardSupport/inc/ClockManager.h"
 #include "driverlib/sysctl.h"
 #include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
@@ -24,6 +25,7 @@
 
 #include "driverlib/timer.h"
 #include "driverlib/uart.h"
+#include "utils/uartstdio.h"
 
 #define DEBOUNCE_S          2/10
 #define UPDATE_S            8/10
@@ -65,7 +67,7 @@ struct Ball game_ball;
 static uint32_t lane_colors[] = {LCD_RED, LCD_ORANGE, LCD_YELLOW, LCD_GREEN, LCD_BLUE, LCD_PURPLE, LCD_PINK};
 static Lane_t Lanes[NUM_LANES];
 
-static uint16_t num_temp_thrds = 0;     // number of temporary threads, ie. ball, wall, star, wall_generator
+static uint16_t num_temp_thrds = 0;     // number of temporary threads and tasks, ie. ball, wall, star, wall_generator
 
 volatile bool kill_thrds;               // Flag to start killing temporary threads
 volatile bool restart = false;          // Flag to reboot the game cycle
@@ -73,11 +75,14 @@ volatile bool update_ready = true;      // Flag to update the game_ball's onscre
 volatile bool new_buffer = false;       // Flag when new UART message received
 
 
+static threadId_t ball_id, star_id;     // EDF threads, their job and miss counts are dumped at game over
+
 static uint16_t score;
 static bool score_flag;                 // Flag when score has been updated
 
 static uint8_t movement = 0;            // The number of lanes to move on next game_ball update
 static uint8_t move_buffer;             // Buffer that stores last UART transmission (smile, face, or nothing)
+static volatile uint8_t uart_rx;        // Last byte grabbed by the UART top half
 
 static int32_t coords[2];               // Used for joystick input. Debug only
 
@@ -99,9 +104,10 @@ void initLanes(void)
 void drawLanes(void)
 {
     // make sure you call LCD Mutex before calling this.
+    // queued for DMA, the next synchronous draw waits for them
     for (int i = 0; i < NUM_LANES; i++)
     {
-        LCD_DrawRectangle(0, Lanes[i].top, MAX_SCREEN_X, LANE_WIDTH + i, lane_colors[i]);
+        LCD_DrawRectangleAsync(0, Lanes[i].top, MAX_SCREEN_X, LANE_WIDTH + i, lane_colors[i]);
     }
 }
 
@@ -109,7 +115,7 @@ void clearLanes(uint32_t color)
 {
     for (int i = 0; i < NUM_LANES; i++)
     {
-        LCD_DrawRectangle(0, Lanes[i].top, MAX_SCREEN_X, LANE_WIDTH + i, color);
+        LCD_DrawRectangleAsync(0, Lanes[i].top, MAX_SCREEN_X, LANE_WIDTH + i, color);
     }
 }
 
@@ -160,40 +166,43 @@ void UpdateGameBall(void)
     }
     */
 
-    // erase ball
-    G8RTOS_WaitSemaphore(&LCD_mutex);
-    LCD_DrawRectangle(game_ball.xpos, game_ball.ypos, game_ball.width, game_ball.width, Lanes[game_ball.lane].color);
-    G8RTOS_SignalSemaphore(&LCD_mutex);
-
-    if (move_buffer == SMILE)
-    {
-        game_ball.width = 10;
-        movement = 1;
-    }
-    else if (move_buffer == FACE)
+    PROFILE_SCOPE("UpdateGameBall")
     {
-        game_ball.width = 7;
-        movement = 0;
-    }
-    else
-    {
-        game_ball.width = 4;
-    }
+        // erase ball
+        G8RTOS_WaitSemaphore(&LCD_mutex);
+        LCD_DrawRectangle(game_ball.xpos, game_ball.ypos, game_ball.width, game_ball.width, Lanes[game_ball.lane].color);
+        G8RTOS_SignalSemaphore(&LCD_mutex);
 
-    if (update_ready == true)
-    {
-        game_ball.lane = (NUM_LANES + game_ball.lane - movement) % NUM_LANES; //move up not down
-        update_ready = false;
-        TimerLoadSet(TIMER1_BASE, TIMER_A, SysCtlClockGet() * UPDATE_S);
-        TimerEnable(TIMER1_BASE, TIMER_A);
-    }
+        if (move_buffer == SMILE)
+        {
+            game_ball.width = 10;
+            movement = 1;
+        }
+        else if (move_buffer == FACE)
+        {
+            game_ball.width = 7;
+            movement = 0;
+        }
+        else
+        {
+            game_ball.width = 4;
+        }
 
-    game_ball.ypos = get_ball_ypos(game_ball.lane, game_ball.width);
+        if (update_ready == true)
+        {
+            game_ball.lane = (NUM_LANES + game_ball.lane - movement) % NUM_LANES; //move up not down
+            update_ready = false;
+            TimerLoadSet(TIMER1_BASE, TIMER_A, SysCtlClockGet() * UPDATE_S);
+            TimerEnable(TIMER1_BASE, TIMER_A);
+        }
 
-    // plot ball
-    G8RTOS_WaitSemaphore(&LCD_mutex);
-    LCD_DrawRectangle(game_ball.xpos, game_ball.ypos, game_ball.width, game_ball.width, game_ball.color);
-    G8RTOS_SignalSemaphore(&LCD_mutex);
+        game_ball.ypos = get_ball_ypos(game_ball.lane, game_ball.width);
+
+        // plot ball
+        G8RTOS_WaitSemaphore(&LCD_mutex);
+        LCD_DrawRectangle(game_ball.xpos, game_ball.ypos, game_ball.width, game_ball.width, game_ball.color);
+        G8RTOS_SignalSemaphore(&LCD_mutex);
+    }
 }
 
 /*
@@ -243,7 +252,7 @@ void print_score(void)
 {
     start_temp_thread();
 
-    char str[12];
+    char str[16];
     while(1)
     {
         if(kill_thrds)
@@ -252,10 +261,9 @@ void print_score(void)
     if (score_flag)
     {
         score_flag = false;
-        sprintf(str, "Score: %d", score);
+        sprintf(str, "Score: %-5d", score);     // padded so the old digits get painted over
         G8RTOS_WaitSemaphore(&LCD_mutex);
-        LCD_DrawRectangle(3, 3, 100, 15, Lanes[0].color);
-        LCD_Text(3, 3, (uint8_t*)str, LCD_WHITE);
+        LCD_TextBg(3, 3, (uint8_t*)str, LCD_WHITE, Lanes[0].color);
         G8RTOS_SignalSemaphore(&LCD_mutex);
     }
 
@@ -294,15 +302,20 @@ void game_over(void)
 {
     seedRandom();
     initLanes();
+    G8RTOS_RegisterHealthCheck(1000);
 
     while(1)
     {
+        G8RTOS_CheckIn();
         score = 0;
         score_flag = true;
         kill_thrds = false;
         G8RTOS_InitSemaphore(&game_over_sem, 0);
         G8RTOS_InitSemaphore(&ball_ready, 0);
 
+        // full speed while the game runs
+        ClockManager_SetSpeed(CLOCK_80MHZ);
+
         // Pregame clear screen
         G8RTOS_WaitSemaphore(&LCD_mutex);
         drawLanes();
@@ -312,36 +325,68 @@ void game_over(void)
         G8RTOS_AddThread(print_score, 254, "ball");
 
         // ball thread
-        G8RTOS_AddThread(ball_thread, 251, "ball");
+        G8RTOS_AddEDFThread(ball_thread, SLEEP_TICKS, SLEEP_TICKS, "ball");
         G8RTOS_WaitSemaphore(&ball_ready);
 
         // star thread
-        G8RTOS_AddThread(star_thread, 251, "star");
+        G8RTOS_AddEDFThread(star_thread, SLEEP_TICKS, SLEEP_TICKS, "star");
 
         // Add wall generator thread
         G8RTOS_AddThread(wall_generator, 250, "wall_gen");
         // code here: walls are responsible for triggering game_over_sem
 
-        // wait for game over
-        G8RTOS_WaitSemaphore(&game_over_sem);
+        // sample the first moments of the game, dumped with the stats at game over
+        G8RTOS_StartProfiler(PROFILER_RATE_HZ);
+        uint32_t gameStart = SystemTime;
+        uint32_t gameSwitches = G8RTOS_GetContextSwitchCount();
+
+        // wait for game over, checking in while the game runs
+        while (!G8RTOS_WaitSemaphoreTimeout(&game_over_sem, 250))
+            G8RTOS_CheckIn();
+
+        // EDF counts go with the threads, read them before they die
+        uint32_t ballJobs = 0, ballMisses = 0, starJobs = 0, starMisses = 0;
+        G8RTOS_GetEDFStats(ball_id, &ballJobs, &ballMisses);
+        G8RTOS_GetEDFStats(star_id, &starJobs, &starMisses);
         kill_thrds = true;
+        uint32_t gameMs = SystemTime - gameStart;
+        gameSwitches = G8RTOS_GetContextSwitchCount() - gameSwitches;
 
         // wait for all temp threads to die
         while (num_temp_thrds > 0)
+        {
+            G8RTOS_CheckIn();
             sleep(200);
+        }
 
         G8RTOS_WaitSemaphore(&LCD_mutex);
         clearLanes(LCD_RED);
-        LCD_Text(120, 100, "Game Over!", LCD_WHITE);
+        LCD_TextBg(120, 100, "Game Over!", LCD_WHITE, LCD_RED);
         char str[18];
         sprintf(str, "Final score: %d", score);
-        LCD_Text(105, 120, (uint8_t*)str, LCD_WHITE);
+        LCD_TextBg(105, 120, (uint8_t*)str, LCD_WHITE, LCD_RED);
         G8RTOS_SignalSemaphore(&LCD_mutex);
 
+        // nothing moves on the Game Over screen, slow down until the restart
+        ClockManager_SetSpeed(CLOCK_20MHZ);
+
+        G8RTOS_DumpSemaphoreStats(UARTprintf);
+        G8RTOS_DumpHealthStats(UARTprintf);
+        G8RTOS_CheckIn();
+        G8RTOS_DumpProfile(UARTprintf);
+        G8RTOS_DumpProfileScopes(UARTprintf);
+        G8RTOS_ResetProfileScopes();
+        UARTprintf("context switches %u in %u ms, %u per second\n",
+                   gameSwitches, gameMs, (uint32_t)((uint64_t)gameSwitches * 1000 / (gameMs ? gameMs : 1)));
+        UARTprintf("edf ball %u jobs %u misses, star %u jobs %u misses\n", ballJobs, ballMisses, starJobs, starMisses);
+        UARTprintf("lcd window bytes saved %u\n", LCD_GetWindowBytesSaved());
+        LCD_ResetWindowStats();
+
         restart = true;
 
         // wait on interrupt
-        while(restart);
+        while(restart)
+            G8RTOS_CheckIn();
     }
 }
 
@@ -356,6 +401,7 @@ void game_over(void)
 void ball_thread(void)
 {
     start_temp_thread();
+    ball_id = G8RTOS_GetThreadId();
 
     game_ball.width = 7;
     game_ball.lane = NUM_LANES/2;
@@ -369,14 +415,16 @@ void ball_thread(void)
     G8RTOS_SignalSemaphore(&LCD_mutex);
 
     G8RTOS_SignalSemaphore(&ball_ready);
+    G8RTOS_RegisterHealthCheck(500);
 
     while(1)
     {
         if (kill_thrds)
             kill_temp_thread();
 
+        G8RTOS_CheckIn();
         UpdateGameBall();
-        sleep(SLEEP_TICKS);
+        G8RTOS_WaitNextPeriod();
     }
 }
 
@@ -393,6 +441,7 @@ void ball_thread(void)
 void star_thread(void)
 {
     start_temp_thread();
+    star_id = G8RTOS_GetThreadId();
 
     struct Ball star;
 
@@ -429,14 +478,14 @@ void star_thread(void)
         G8RTOS_WaitSemaphore(&LCD_mutex);
         LCD_DrawRectangle(star.xpos, star.ypos, star.width, star.width, star.color);
         G8RTOS_SignalSemaphore(&LCD_mutex);
-        sleep(SLEEP_TICKS);
+        G8RTOS_WaitNextPeriod();
     }
 }
 
 /*
  * Thread: wall_generator
  * ----------------------------
- *   Generates new wall threads at a semi-random interval (1-2 seconds).
+ *   Generates new wall tasks at a semi-random interval (1-2 seconds).
  *   Responsible for killing itself.
  */
 void wall_generator(void)
@@ -449,96 +498,122 @@ void wall_generator(void)
             kill_temp_thread();
 
 
-        G8RTOS_AddThread(wall_thread, 252, "wall");
+        G8RTOS_AddCoopTask(wall_task);
         sleepcount = 1000 + rand() % 1000;
         sleep(sleepcount);
     }
 }
 
 /*
- * Thread: wall_thread
+ * Cooperative task: wall_task
  * ----------------------------
  *   Generates a new wall object in a random lane.
  *   Plots wall object onscreen.
  *
- *   Kills itself when reaches the left side of screen.
- *   Responsible for killing itself.
+ *   Runs stackless inside the cooperative host. The wall
+ *   object is the task's state, so it must be reached through
+ *   the pointer after every yield point.
+ *
+ *   Exits when it reaches the left side of screen.
+ *   Responsible for ending itself.
  */
-void wall_thread(void)
+int32_t wall_task(ctcb_t *task)
 {
+    struct Ball *wall = COOP_STATE(task, struct Ball);
+
+    COOP_BEGIN(task);
+
     start_temp_thread();
 
     // Init walls
-    struct Ball wall;
-
-    wall.color = LCD_WHITE;
-    wall.velocity = 2;
-    wall.width = 10;
-    wall.lane = rand() % NUM_LANES;
-    wall.xpos = MAX_SCREEN_X - wall.width;
-    wall.ypos = get_ball_ypos(wall.lane, wall.width);
+    wall->color = LCD_WHITE;
+    wall->velocity = 2;
+    wall->width = 10;
+    wall->lane = rand() % NUM_LANES;
+    wall->xpos = MAX_SCREEN_X - wall->width;
+    wall->ypos = get_ball_ypos(wall->lane, wall->width);
 
     while(1)
     {
         if (kill_thrds)
-            kill_temp_thread();
+            break;
 
 
         // plot ball
-        G8RTOS_WaitSemaphore(&LCD_mutex);
-        LCD_DrawRectangle(wall.xpos, wall.ypos, wall.width, wall.width, wall.color);
-        G8RTOS_SignalSemaphore(&LCD_mutex);
+        PROFILE_SCOPE("draw_wall")
+        {
+            G8RTOS_WaitSemaphore(&LCD_mutex);
+            LCD_DrawRectangle(wall->xpos, wall->ypos, wall->width, wall->width, wall->color);
+            G8RTOS_SignalSemaphore(&LCD_mutex);
+        }
 
         // check collision
-        if (game_ball.xpos + (game_ball.width-1) >= wall.xpos  &&
-            game_ball.xpos <= wall.xpos + (wall.width-1) &&
-            game_ball.lane == wall.lane)
+        if (game_ball.xpos + (game_ball.width-1) >= wall->xpos  &&
+            game_ball.xpos <= wall->xpos + (wall->width-1) &&
+            game_ball.lane == wall->lane)
         {
             // game over!
             G8RTOS_SignalSemaphore(&game_over_sem);
-            kill_temp_thread();
+            break;
         }
 
-        sleep(SLEEP_TICKS);
+        COOP_SLEEP(task, SLEEP_TICKS);
 
         // erase ball
         G8RTOS_WaitSemaphore(&LCD_mutex);
-        LCD_DrawRectangle(wall.xpos, wall.ypos, wall.width, wall.width, Lanes[wall.lane].color);
+        LCD_DrawRectangle(wall->xpos, wall->ypos, wall->width, wall->width, Lanes[wall->lane].color);
         G8RTOS_SignalSemaphore(&LCD_mutex);
 
-        UpdateWall(&wall);
+        UpdateWall(wall);
 
-        if (wall.xpos < 0)
-        {
-            kill_temp_thread();
-        }
+        if (wall->xpos < 0)
+            break;
     }
+
+    num_temp_thrds--;
+
+    COOP_END(task);
 }
 
 /*
  * Aperiodic thread: UART_int_handler
  * ----------------------------
+ *   Top half of the UART1 deferred event.
  *   Handles UART transmission from beaglebone and
- *   moves data into buffer for later.
- *
- *   Sets the new_buffer flag to signal to the
- *   game_ball thread.
+ *   moves the last received byte into uart_rx.
  */
 void UART_int_handler(void)
 {
-    int32_t val = 0;
+    PROFILE_SCOPE("UART_int_handler")
+    {
+        int32_t val = 0;
 
-    uint32_t ui32Status;
-    ui32Status = UARTIntStatus(UART1_BASE, true);
-    UARTIntClear(UART1_BASE, ui32Status);
+        uint32_t ui32Status;
+        ui32Status = UARTIntStatus(UART1_BASE, true);
+        UARTIntClear(UART1_BASE, ui32Status);
 
-    // Loop while there are characters in the receive FIFO.
-    while(UARTCharsAvail(UART1_BASE))
-    {
-          val = UARTCharGetNonBlocking(UART1_BASE);
+        // Loop while there are characters in the receive FIFO.
+        while(UARTCharsAvail(UART1_BASE))
+        {
+              val = UARTCharGetNonBlocking(UART1_BASE);
+        }
+
+        uart_rx = (uint8_t)(val & 0xFF);
     }
+}
 
-    move_buffer = (uint8_t)(val & 0xFF);
+/*
+ * Deferred thread: UART_rx_bottom_half
+ * ----------------------------
+ *   Bottom half of the UART1 deferred event.
+ *   Moves the received byte into buffer for later.
+ *
+ *   Sets the new_buffer flag to signal to the
+ *   game_ball thread.
+ */
+void UART_rx_bottom_half(void)
+{
+    move_buffer = uart_rx;
     new_buffer = true;
 }
 
@@ -628,3 +703,19 @@ void P_read_joys(void)
      else
          writeFIFO(FIFO_INPUT, 0);
 }
+
+/*
+ * Fault hook: stack_fault_hook
+ * ----------------------------
+ *  Runs from the MemManage handler when a thread
+ *  overflows its stack.
+ *
+ *  Prints the thread over the polled console, the
+ *  LCD may be mid-frame for the thread it preempted
+ *  and takes locks. The system halts once it returns.
+ */
+void stack_fault_hook(fault_t *fault)
+{
+    UARTprintf("STACK OVERFLOW in %s (thread %u) at %x, MMFSR %x\n",
+               fault->Threadname, (uint32_t)fault->ThreadID, fault->faultAddress, fault->faultStatus);
+}
@@ -19,11 +19,14 @@ void game_over(void);
 void ball_thread(void);
 void star_thread(void);
 void wall_generator(void);
-void wall_thread(void);
+int32_t wall_task(ctcb_t *task);
 void print_score(void);
 
 void wait_for_tap(void);
 void SwitchDebounce(void);
+void UART_int_handler(void);
+void UART_rx_bottom_half(void);
+void stack_fault_hook(fault_t *fault);
 
 /* helpers */
 void seedRandom(void);
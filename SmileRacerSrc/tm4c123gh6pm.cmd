@@ -36,8 +36,14 @@ SECTIONS
     .init_array : > FLASH
 
     .vtable :   > 0x20000000
+
+    /* Hot code run from SRAM, copied by ResetISR. Runs above the 1 KB the  */
+    /* vector table is copied to, even when .vtable itself is not linked    */
+    .ramfunc :  LOAD = FLASH, RUN = 0x20000400,
+                LOAD_START(__ramfunc_load), RUN_START(__ramfunc_run), SIZE(__ramfunc_size)
     .data   :   > SRAM
     .bss    :   > SRAM
+    .noinit :   > SRAM, type = NOINIT
     .sysmem :   > SRAM
     .stack  :   > SRAM
 }
@@ -49,6 +49,15 @@ extern void _c_int00(void);
 //*****************************************************************************
 extern uint32_t __STACK_TOP;
 
+//*****************************************************************************
+//
+// Linker variables for the .ramfunc section, loaded in flash and run in SRAM.
+//
+//*****************************************************************************
+extern uint32_t __ramfunc_load;
+extern uint32_t __ramfunc_run;
+extern uint32_t __ramfunc_size;
+
 //*****************************************************************************
 //
 // External declarations for the interrupt handlers used by the application.
@@ -58,6 +67,8 @@ extern uint32_t __STACK_TOP;
 extern void PortEIntHandler (void);
 extern void SysTick_Handler(void);
 extern void PendSV_Handler(void);
+extern void SVC_Handler(void);
+extern void MemManage_Handler(void);
 extern void LCDtap(void);
 extern void SwitchDebounce(void);
 extern void UpdateDebounce(void);
@@ -78,14 +89,14 @@ void (* const g_pfnVectors[])(void) =
     ResetISR,                               // The reset handler
     NmiSR,                                  // The NMI handler
     FaultISR,                               // The hard fault handler
-    IntDefaultHandler,                      // The MPU fault handler
+    MemManage_Handler,                      // The MPU fault handler
     IntDefaultHandler,                      // The bus fault handler
     IntDefaultHandler,                      // The usage fault handler
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
-    IntDefaultHandler,                      // SVCall handler
+    SVC_Handler,                            // SVCall handler
     IntDefaultHandler,                      // Debug monitor handler
     0,                                      // Reserved
     PendSV_Handler,                         // The PendSV handler
@@ -244,6 +255,18 @@ void (* const g_pfnVectors[])(void) =
 void
 ResetISR(void)
 {
+    //
+    // Copy the .ramfunc section from flash to SRAM before anything can call
+    // into it.
+    //
+    uint32_t *pui32Src = &__ramfunc_load;
+    uint32_t *pui32Dest = &__ramfunc_run;
+    uint32_t ui32Words = ((uint32_t)&__ramfunc_size + 3) / 4;
+    while(ui32Words--)
+    {
+        *pui32Dest++ = *pui32Src++;
+    }
+
     //
     // Jump to the CCS C initialization routine.  This will enable the
     // floating-point unit as well, so that does not need to be done here.